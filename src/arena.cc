@@ -7,7 +7,11 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <assert.h>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
 
 #include "src/arena.h"
 #include "src/robot.h"
@@ -21,12 +25,56 @@
 #include "src/home_base.h"
 #include "src/event_recharge.h"
 #include "src/event_command.h"
+#include "src/kinematics.h"
+#include "src/entity_interaction.h"
+#include "src/input_log.h"
+#include "src/trajectory_recorder.h"
 
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+// Distance an entity is pushed back into the arena after running into a wall
+static const double kWallPushback = 10;
+
+// Positions are whole pixels, so an entity can end up to sqrt(2) pixels off
+// the straight line it was moved along
+static const double kPixelRounding = 1.5;
+
+// First bytes of every snapshot, and the version of its layout
+static const uint32_t kSnapshotMagic = 0x4e534152; // "RASN"
+static const uint32_t kSnapshotVersion = 2;
+
+// Offset basis and prime of the 64-bit FNV-1a hash
+static const uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+static const uint64_t kFnvPrime = 0x100000001b3ULL;
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Get the fraction of a move from start to end at which a coordinate
+ * reaches limit, or 0 if it is already past it at the start.
+ */
+static double TimeToReach(double start, double end, double limit) {
+	if (end == start) {
+		return 0;
+	}
+	return std::min(std::max((limit - start) / (end - start), 0.0), 1.0);
+}
+
+/**
+ * @brief Get the point a fraction t of the way from start to end (exactly end
+ * when t is 1).
+ */
+static double Lerp(double start, double end, double t) {
+	return t < 1 ? start + (end - start) * t : end;
+}
+
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -36,53 +84,139 @@ NAMESPACE_BEGIN(csci3081);
  * @param params Parameters needed to instantiate an arena
  */
 Arena::Arena(const struct arena_params* const params) :
-	player_(new Player(&params->player)),
-	recharge_station_(new RechargeStation(params->recharge_station.radius,
-	                                      params->recharge_station.pos,
-	                                      params->recharge_station.color)),
-	home_base_(new HomeBase(&params->home_base)), entities_(), mobile_entities_(),
-	robot_entities_(), superbot_entities_(), n_superbots_(0),
-	n_obstacles_(params->n_obstacles), n_robots_(params->n_robots),
-	x_dim_(params->x_dim), y_dim_(params->y_dim), n_players_(1) {
+	x_dim_(params->x_dim), y_dim_(params->y_dim), n_players_(1),
+	n_obstacles_(params->obstacles.size()), n_robots_(params->robots.size()),
+	n_superbots_(0), timestep_(std::max(params->timestep, 1u)),
+	random_(params->seed), ticks_(0), input_log_(nullptr),
+	trajectory_(nullptr), player_pool_(), recharge_station_pool_(),
+	home_base_pool_(), obstacle_pool_(), robot_pool_(), superbot_pool_(),
+	player_(nullptr), recharge_station_(nullptr), home_base_(nullptr),
+	entities_(), mobile_entities_(),
+	robot_entities_(), superbot_entities_(), obstacle_view_(), robot_view_(),
+	superbot_view_(), store_(), player_slot_(0),
+	recharge_station_slot_(0), home_base_slot_(0), first_robot_slot_(0),
+	first_robot_mobile_(0), first_superbot_slot_(0), in_play_(), asleep_(), awake_(), sleeping_(), unfrozen_(),
+	sleeping_changed_(true), max_radius_(0), max_delta_(0), max_step_(0),
+	entity_grid_(), sleeping_grid_(), obstacle_tree_(), workers_(), scratch_(1),
+	contacts_(),
+	sensed_() {
+	// Every entity is made up front, so each pool is allocated exactly once
+	player_pool_.Reserve(1);
+	recharge_station_pool_.Reserve(1);
+	home_base_pool_.Reserve(1);
+	obstacle_pool_.Reserve(n_obstacles_);
+	robot_pool_.Reserve(n_robots_);
+	superbot_pool_.Reserve(n_robots_);
+	player_ = player_pool_.Create(&params->player);
+	recharge_station_ = recharge_station_pool_.Create(
+		params->recharge_station.radius, params->recharge_station.pos,
+		params->recharge_station.color);
+	home_base_ = home_base_pool_.Create(&params->home_base);
 
 	home_base_->set_heading_angle(75);
 	player_->set_heading_angle(37);
-	entities_.push_back(player_);
-	mobile_entities_.push_back(player_);
-	entities_.push_back(recharge_station_);
-	entities_.push_back(home_base_);
-	mobile_entities_.push_back(home_base_);
+
+	/*
+	 * Ids number the entities of each kind within this arena (the recharge
+	 * station counts as obstacle 0 and the home base as player 1), so separate
+	 * arenas don't share any counters.
+	 */
+	player_->set_id(0);
+	home_base_->set_id(1);
+	recharge_station_->set_id(0);
+
+	/*
+	 * Nothing is ever removed from the arena, so every slot in the store keeps
+	 * its entity for the whole game. Each superbot has a slot of its own after
+	 * the robots, in the order they are promoted, and is out of play until it
+	 * is; promoting a robot takes the robot's slot out of play instead, and
+	 * puts the superbot in its place in the views (see PlaceRobot()).
+	 */
+	assert(params->superbots.size() >= n_robots_);
+	entities_.reserve(3 + n_obstacles_ + n_robots_);
+	mobile_entities_.reserve(2 + n_robots_);
+	robot_entities_.reserve(n_robots_);
+	superbot_entities_.reserve(n_robots_);
+	obstacle_view_.reserve(1 + n_obstacles_);
+	robot_view_.reserve(n_robots_);
+	superbot_view_.reserve(n_robots_);
+	store_.Reserve(3 + n_obstacles_ + 2 * n_robots_);
+	player_slot_ = AddEntity(player_);
+	recharge_station_slot_ = AddEntity(recharge_station_);
+	home_base_slot_ = AddEntity(home_base_);
 
 	// initializes obstacles
 	for (size_t i = 0; i < n_obstacles_; ++i) {
-		entities_.push_back(new Obstacle(
-					    params->obstacles[i].radius,
-					    params->obstacles[i].pos,
-					    params->obstacles[i].color));
+		Obstacle * o = obstacle_pool_.Create(params->obstacles[i].radius,
+		                                     params->obstacles[i].pos,
+		                                     params->obstacles[i].color);
+		o->set_id(1 + i);
+		AddEntity(o);
 	}
 
 	// initializes robots
+	first_robot_slot_ = entities_.size();
+	first_robot_mobile_ = mobile_entities_.size();
 	for (size_t i = 0; i < n_robots_; ++i) {
-		Robot * r = new Robot(&params->robots[i]);
-		entities_.push_back(r);
-		mobile_entities_.push_back(r);
+		Robot * r = robot_pool_.Create(&params->robots[i]);
+		r->set_id(i);
+		AddEntity(r);
 		robot_entities_.push_back(r);
 	}
 
 	// initializes a superbot for each robot
 	for (size_t i = 0; i < n_robots_; ++i) {
-		SuperBot * s = new SuperBot(&params->superbots[i]);
+		SuperBot * s = superbot_pool_.Create(&params->superbots[i]);
+		s->set_id(i);
 		superbot_entities_.push_back(s);
 	}
+	first_superbot_slot_ = store_.size();
+	for (auto ent : superbot_entities_) {
+		store_.Add(ent);
+	}
+
+	/*
+	 * The obstacles never move, so they go in a tree of their own, once. Size
+	 * the broad phase grid cells so that any mobile entity close enough to
+	 * collide with or be sensed by another lies in a neighboring cell.
+	 */
+	std::vector<unsigned int> obstacles;
+	double max_range = 0;
+	for (unsigned int i = 0; i < store_.size(); ++i) {
+		if (!store_.mobile(i)) {
+			obstacles.push_back(i);
+			continue;
+		}
+		max_radius_ = std::max(max_radius_, store_.radius[i]);
+		max_delta_ = std::max(max_delta_, store_.collision_delta[i]);
+	}
+	obstacle_tree_.Build(store_.x.data(), store_.y.data(), store_.radius.data(),
+	                     obstacles.data(), obstacles.size());
+	for (auto ent : superbot_entities_) {
+		max_range = std::max(max_range, ent->get_proximity_range());
+	}
+	for (auto ent : robot_entities_) {
+		max_range = std::max(max_range, ent->get_proximity_range());
+	}
+	max_range = std::max(max_range, max_delta_);
+	entity_grid_.Init(x_dim_, y_dim_, 2 * max_radius_ + max_range);
+	sleeping_grid_.Init(x_dim_, y_dim_, 2 * max_radius_ + max_range);
+
+	// Everything that can move starts awake, but the superbots start out of
+	// play
+	GatherInPlay();
+
+	// Room for a contact per entity up front; the buffers only grow past it
+	// in a crowded tick, and keep what they grew to
+	scratch_[0].contacts.reserve(store_.size());
 }
 
 /**
  * @brief Arena destructor
  */
 Arena::~Arena(void) {
-	for (auto ent : entities_) {
-		delete ent;
-	}
+	// The entities are all destroyed and freed with the pools they live in,
+	// including the superbots that never came into play
 }
 /*******************************************************************************
  * Member Functions
@@ -91,84 +225,189 @@ Arena::~Arena(void) {
  * @brief Reset all entities in the arena, effectively restarting the game.
  */
 void Arena::Reset(void) {
-	// erase all remaining robots from the entity vectors then push all back on
-	for (auto ent : robot_entities_) {
-		entities_.erase(std::remove(entities_.begin(), entities_.end(), ent), entities_.end());
-		mobile_entities_.erase(std::remove(mobile_entities_.begin(),
-		                                   mobile_entities_.end(), ent), mobile_entities_.end());
-		entities_.push_back(ent);
-		mobile_entities_.push_back(ent);
+	if (input_log_) {
+		input_log_->Record(ticks_, InputLog::kReset);
 	}
 
-	// erase all remaining superbots from entity vectors so they aren't drawn or updated
-	for (auto ent : superbot_entities_) {
-		entities_.erase(std::remove(entities_.begin(), entities_.end(), ent), entities_.end());
-		mobile_entities_.erase(std::remove(mobile_entities_.begin(),
-		                                   mobile_entities_.end(), ent), mobile_entities_.end());
+	// put every robot back in its slot, in place of its superbot if it was
+	// promoted, so the superbots aren't drawn or updated
+	for (size_t i = 0; i < n_robots_; ++i) {
+		PlaceRobot(i, robot_entities_[i]);
 	}
+	superbot_view_.clear();
 
 	// Reset all entities to newly minted state
 	for (auto ent : entities_) {
 		ent->Reset();
 	}
+	n_superbots_ = 0;
+
+	// Wake everything up, in case it was reset while asleep
+	GatherInPlay();
 }
 
 /**
- * @brief Get a list of all obstacles (i.e. non-mobile entities in the arena).
- * @return std::vector<Obstacle*> A vector containing the obstacles in the arena
+ * @brief Save everything about the game in play that changes from tick to tick
+ * as a block of bytes, so it can be picked up again from this point with
+ * Restore().
+ * @param out Set to the snapshot; its capacity is reused
  */
-std::vector<Obstacle*> Arena::obstacles(void) {
-	std::vector<Obstacle*> res;
-	for (auto ent : entities_) {
-		Obstacle* o = dynamic_cast<Obstacle*>(ent);
-		if (o) {
-			res.push_back(o);
+void Arena::Snapshot(std::vector<uint8_t> * const out) const {
+	out->clear();
+	StateWriter w(out);
+	w.Write(kSnapshotMagic);
+	w.Write(kSnapshotVersion);
+	w.Write(uint64_t(0)); // size of the snapshot, filled in at the end
+	w.Write(static_cast<uint32_t>(n_obstacles_));
+	w.Write(static_cast<uint32_t>(n_robots_));
+	w.Write(ticks_);
+	random_.SaveState(&w);
+
+	// Superbot k took the place of the robot in the k-th slot it names
+	w.Write(static_cast<uint32_t>(n_superbots_));
+	std::vector<uint32_t> replaced(n_superbots_);
+	for (uint32_t i = 0; i < n_robots_; ++i) {
+		const Robot * ent = robot_view_[i];
+		if (ent->get_type() == kSuperBot) {
+			replaced[ent->get_id()] = i;
 		}
 	}
-	return res;
+	for (auto i : replaced) {
+		w.Write(i);
+	}
+
+	// Superbots that haven't come into play yet can still have been left
+	// changed by an earlier game, so they are all saved too
+	player_->SaveState(&w);
+	home_base_->SaveState(&w);
+	for (auto ent : robot_entities_) {
+		ent->SaveState(&w);
+	}
+	for (auto ent : superbot_entities_) {
+		ent->SaveState(&w);
+	}
+
+	uint64_t size = out->size();
+	std::memcpy(out->data() + 2 * sizeof(uint32_t), &size, sizeof(size));
 }
 
 /**
- * @brief Get a list of all robots.
- * @return std::vector<Robot*> A vector containing the Robots in the arena
+ * @brief Put the game back to the point a Snapshot() was taken at.
+ * @param data First byte of the snapshot
+ * @param size Size of the snapshot in bytes
+ * @return bool Whether the snapshot could be restored
  */
-std::vector<Robot*> Arena::robots(void) {
-	std::vector<Robot*> res;
-	for (auto ent : mobile_entities_) {
-		Robot* o = dynamic_cast<Robot*>(ent);
-		if (o) {
-			res.push_back(o);
-		}
+bool Arena::Restore(const uint8_t * data, size_t size) {
+	StateReader r(data, size);
+	uint32_t magic = 0, version = 0, n_obstacles = 0, n_robots = 0;
+	uint64_t snapshot_size = 0;
+	if (r.remaining() < 4 * sizeof(uint32_t) + sizeof(uint64_t)) {
+		return false;
+	}
+	r.Read(&magic);
+	r.Read(&version);
+	r.Read(&snapshot_size);
+	r.Read(&n_obstacles);
+	r.Read(&n_robots);
+	if (magic != kSnapshotMagic || version != kSnapshotVersion ||
+	    snapshot_size != size || n_obstacles != n_obstacles_ ||
+	    n_robots != n_robots_) {
+		return false;
 	}
-	return res;
+	r.Read(&ticks_);
+	random_.LoadState(&r);
+
+	// Put every robot back in its slot, then the superbots in play in the
+	// order they were promoted, as Reset() and the game did
+	for (size_t i = 0; i < n_robots_; ++i) {
+		PlaceRobot(i, robot_entities_[i]);
+	}
+	superbot_view_.clear();
+	uint32_t n_superbots = 0;
+	r.Read(&n_superbots);
+	n_superbots_ = n_superbots;
+	for (unsigned int k = 0; k < n_superbots_; ++k) {
+		uint32_t i = 0;
+		r.Read(&i);
+		PlaceRobot(i, superbot_entities_[k]);
+	}
+
+	player_->LoadState(&r);
+	home_base_->LoadState(&r);
+	for (auto ent : robot_entities_) {
+		ent->LoadState(&r);
+	}
+	for (auto ent : superbot_entities_) {
+		ent->LoadState(&r);
+	}
+	assert(!r.failed() && r.remaining() == 0);
+
+	// Everything starts awake, as after Reset(); sleeping never changes how
+	// the game plays out
+	GatherInPlay();
+	return true;
 }
 
 /**
- * @brief Get a list of all Superbots.
- * @return std::vector<SuperBot*> A vector containing the Superbots in the arena
+ * @brief Get a 64-bit hash of the state of the game in play.
+ * @return uint64_t FNV-1a hash of the arena's snapshot
  */
-std::vector<SuperBot*> Arena::superbots(void) {
-	std::vector<SuperBot*> res;
-	for (auto ent : mobile_entities_) {
-		SuperBot* o = dynamic_cast<SuperBot*>(ent);
-		if (o) {
-			res.push_back(o);
-		}
+uint64_t Arena::StateHash(void) const {
+	std::vector<uint8_t> snapshot;
+	Snapshot(&snapshot);
+	uint64_t hash = kFnvOffsetBasis;
+	for (auto byte : snapshot) {
+		hash = (hash ^ byte) * kFnvPrime;
 	}
-	return res;
+	return hash;
 }
 
 /**
- * @brief Advance the simulation by the specified # of steps.
+ * @brief Get the type and id of each entity a trajectory of the arena follows,
+ * in the order they are recorded.
+ * @return std::vector<trajectory_entity> The player, the home base, then each
+ * robot
+ */
+std::vector<struct trajectory_entity> Arena::trajectory_entities(void) const {
+	std::vector<struct trajectory_entity> entities(2 + n_robots_);
+	entities[0].type = kPlayer;
+	entities[0].id = player_->get_id();
+	entities[1].type = kHomebase;
+	entities[1].id = home_base_->get_id();
+	for (unsigned int i = 0; i < n_robots_; ++i) {
+		entities[2 + i].type = kRobot;
+		entities[2 + i].id = robot_entities_[i]->get_id();
+	}
+	return entities;
+}
+
+/**
+ * @brief Advance the simulation by one tick, which covers as many timesteps as
+ * the arena_params it was built from ask for.
  * @return int Status of the game (0 = player loses, 1 = player wins, 2 = continue game)
  */
 int Arena::AdvanceTime(void) {
+	++ticks_;
 	for (size_t i = 0; i < 1; ++i) {
 		return UpdateEntitiesTimestep();
 	}
 	return 2;
 }
 
+/**
+ * @brief Set the number of threads each timestep is spread across. The outcome
+ * of every timestep is the same no matter how many are used.
+ * @param n_threads Number of threads, including the caller (1 runs everything
+ * on the calling thread)
+ */
+void Arena::set_threads(unsigned int n_threads) {
+	workers_.Resize(n_threads);
+	scratch_.resize(workers_.size());
+	for (auto& scratch : scratch_) {
+		scratch.contacts.reserve(store_.size());
+	}
+}
+
 /**
  * @brief Returns the level of the player battery.
  * @return double Player's battery level
@@ -182,7 +421,308 @@ double Arena::get_player_battery_level(void) {
  * @param head_angle Heading angle in degrees
  */
 void Arena::home_base_change_direction(double head_angle) {
-	home_base_->set_heading_angle(head_angle);
+	store_.set_heading(home_base_slot_, head_angle);
+}
+
+/**
+ * @brief Add an entity to the arena, in entities_, mobile_entities_ (if it
+ * can move), the views of its type and the store.
+ * @param ent The entity to add
+ * @return unsigned int The slot of the entity in the store
+ */
+unsigned int Arena::AddEntity(ArenaEntity * ent) {
+	entities_.push_back(ent);
+	if (EntityStore::IsMobile(ent->get_type())) {
+		mobile_entities_.push_back(static_cast<ArenaMobileEntity*>(ent));
+	}
+	switch (ent->get_type()) {
+	case kObstacle:
+	case kRechargeStation:
+		obstacle_view_.push_back(static_cast<Obstacle*>(ent));
+		break;
+	case kSuperBot:
+		superbot_view_.push_back(static_cast<SuperBot*>(ent));
+		robot_view_.push_back(static_cast<Robot*>(ent));
+		break;
+	case kRobot:
+		robot_view_.push_back(static_cast<Robot*>(ent));
+		break;
+	default:
+		break;
+	}
+	return store_.Add(ent);
+}
+
+/**
+ * @brief Put a robot or superbot in the place of the i-th robot, in entities_,
+ * mobile_entities_ and the views. Nothing else moves, so this takes constant
+ * time. The store is left as it is; see SetInPlay().
+ * @param i Index of the robot in robot_entities_
+ * @param ent The robot, or the superbot it has been promoted to
+ */
+void Arena::PlaceRobot(unsigned int i, Robot * ent) {
+	entities_[first_robot_slot_ + i] = ent;
+	mobile_entities_[first_robot_mobile_ + i] = ent;
+	robot_view_[i] = ent;
+	if (ent->get_type() == kSuperBot) {
+		superbot_view_.push_back(static_cast<SuperBot*>(ent));
+	}
+}
+
+/**
+ * @brief Bring the entity in a slot of the store into play, or take it out of
+ * play. Every pass skips the entities out of play.
+ * @param i Slot of the entity
+ * @param in_play Whether it is in play
+ */
+void Arena::SetInPlay(unsigned int i, bool in_play) {
+	in_play_[i] = in_play;
+	if (in_play) {
+		store_.Gather(i);
+	}
+	else {
+		// So the batched move leaves it where it is
+		store_.speed[i] = 0;
+	}
+}
+
+/**
+ * @brief Refresh the store from the entities, take the promoted robots and the
+ * superbots not promoted to yet out of play, and wake everything up.
+ */
+void Arena::GatherInPlay(void) {
+	store_.Gather();
+	in_play_.assign(store_.size(), true);
+	for (unsigned int i = 0; i < n_robots_; ++i) {
+		if (robot_view_[i] != robot_entities_[i]) {
+			SetInPlay(first_robot_slot_ + i, false);
+		}
+	}
+	for (unsigned int k = n_superbots_; k < n_robots_; ++k) {
+		SetInPlay(first_superbot_slot_ + k, false);
+	}
+	asleep_.assign(store_.size(), false);
+	unfrozen_.clear();
+	SortSleeping();
+}
+
+/**
+ * @brief Update the velocity of every mobile entity, then move them all along
+ * their headings in one batched pass over the store.
+ * @param dt The # of timesteps to advance
+ */
+void Arena::MoveEntities(unsigned int dt) {
+	// Every entity only touches its own slot and its own state, so each
+	// worker moves its range of the awake entities start to finish.
+	ParallelFor(awake_.size(), [this, dt](unsigned int t, size_t begin,
+	                                      size_t end) {
+		scratch_[t].max_step2 = 0;
+		if (begin == end) {
+			return;
+		}
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = awake_[k];
+			static_cast<ArenaMobileEntity*>(store_.entity[i])->UpdateVelocity();
+			store_.Gather(i);
+		}
+
+		// The immobile and sleeping entities in between have a speed of 0 in
+		// the store, so the kernel leaves them where they are.
+		size_t first = awake_[begin];
+		size_t last = awake_[end - 1] + 1;
+		IntegratePositions(store_.heading.data() + first, store_.speed.data() + first,
+		                   store_.x.data() + first, store_.y.data() + first,
+		                   last - first, dt);
+
+		double max_step2 = 0;
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = awake_[k];
+			double dx = store_.x[i] - store_.start_x[i];
+			double dy = store_.y[i] - store_.start_y[i];
+			max_step2 = std::max(max_step2, dx * dx + dy * dy);
+			ArenaMobileEntity * ent = static_cast<ArenaMobileEntity*>(store_.entity[i]);
+			Position old_pos = ent->get_pos();
+			ent->set_pos(Position(store_.x[i], store_.y[i]));
+			ent->PositionUpdated(old_pos, dt);
+		}
+		scratch_[t].max_step2 = max_step2;
+	});
+
+	// Bounds how far apart the end positions the grid is built from can be
+	// for entities that touched during the tick, and how far the collision
+	// pass can move an entity back along its path
+	double max_step2 = 0;
+	for (const auto& scratch : scratch_) {
+		max_step2 = std::max(max_step2, scratch.max_step2);
+	}
+	max_step_ = std::sqrt(max_step2) + kPixelRounding;
+}
+
+/**
+ * @brief Rebuild the broad phase grid of the awake entities from the positions
+ * in the store, and the sleeping grid too if it has changed.
+ */
+void Arena::RebuildEntityGrid(void) {
+	if (sleeping_changed_) {
+		sleeping_grid_.Rebuild(store_.x.data(), store_.y.data(),
+		                       store_.radius.data(), sleeping_.data(),
+		                       sleeping_.size());
+		sleeping_changed_ = false;
+	}
+	entity_grid_.Rebuild(store_.x.data(), store_.y.data(), store_.radius.data(),
+	                     awake_.data(), awake_.size());
+}
+
+/**
+ * @brief Find the candidates for a query in both broad phase grids and the
+ * obstacle tree.
+ * @param t Worker running the query; its candidates are filled in, in
+ * increasing order
+ * @param x The x coordinate of the query point
+ * @param y The y coordinate of the query point
+ * @param reach Largest distance from the point to the edge of an entity of
+ * interest
+ * @param slack Farthest any awake entity has moved since the grid was rebuilt
+ * (sleeping entities and obstacles don't move)
+ */
+void Arena::QueryEntities(unsigned int t, double x, double y, double reach,
+                          double slack) {
+	worker_scratch& scratch = scratch_[t];
+	entity_grid_.QueryCircles(x, y, reach, slack, &scratch.candidates);
+
+	// Most queries find nothing asleep and no obstacle, so only merge when
+	// there is something to merge
+	if (sleeping_grid_.size() > 0) {
+		sleeping_grid_.QueryCircles(x, y, reach, 0, &scratch.sleeping_candidates);
+		if (!scratch.sleeping_candidates.empty()) {
+			scratch.merged.clear();
+			std::merge(scratch.candidates.begin(), scratch.candidates.end(),
+			           scratch.sleeping_candidates.begin(),
+			           scratch.sleeping_candidates.end(),
+			           std::back_inserter(scratch.merged));
+			scratch.candidates.swap(scratch.merged);
+		}
+	}
+	obstacle_tree_.Query(x, y, reach, &scratch.obstacle_candidates);
+	if (!scratch.obstacle_candidates.empty()) {
+		scratch.merged.clear();
+		std::merge(scratch.candidates.begin(), scratch.candidates.end(),
+		           scratch.obstacle_candidates.begin(),
+		           scratch.obstacle_candidates.end(),
+		           std::back_inserter(scratch.merged));
+		scratch.candidates.swap(scratch.merged);
+	}
+}
+
+/**
+ * @brief Wake the sleeping entities that an awake entity has run into this
+ * tick, before any collisions are handled.
+ * @return bool Whether any entity woke up
+ */
+bool Arena::WakeTouchedEntities(void) {
+	if (sleeping_.empty()) {
+		return false;
+	}
+
+	/*
+	 * A sleeping robot would have found the collision itself, so test from its
+	 * side. Sleeping entities don't move, so only the awake one's path counts.
+	 */
+	ParallelFor(awake_.size(), [this](unsigned int t, size_t begin, size_t end) {
+		worker_scratch& scratch = scratch_[t];
+		scratch.woken.clear();
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = awake_[k];
+			sleeping_grid_.QueryCircles(store_.x[i], store_.y[i],
+			                            store_.radius[i] + max_delta_ + max_step_, 0,
+			                            &scratch.sleeping_candidates);
+			for (auto j : scratch.sleeping_candidates) {
+				contact_record rec;
+				if (TestCollision(j, i, store_.x[i], store_.y[i], &rec)) {
+					scratch.woken.push_back(j);
+				}
+			}
+		}
+	});
+
+	bool woke = false;
+	for (const auto& scratch : scratch_) {
+		for (auto j : scratch.woken) {
+			if (asleep_[j]) {
+				asleep_[j] = false;
+				woke = true;
+			}
+		}
+	}
+	if (woke) {
+		SortSleeping();
+	}
+	return woke;
+}
+
+/**
+ * @brief Put robots that are frozen with nothing touching them to sleep, wake
+ * the ones unfrozen while asleep, and update awake_ and sleeping_ to match.
+ */
+void Arena::UpdateSleeping(void) {
+	bool changed = false;
+	for (auto j : unfrozen_) {
+		if (asleep_[j]) {
+			asleep_[j] = false;
+			changed = true;
+		}
+	}
+	unfrozen_.clear();
+
+	for (auto i : awake_) {
+		const contact& c = contacts_[i];
+		if (store_.type[i] != kRobot || c.wall || c.first_hit != c.end_hit ||
+		    !static_cast<Robot*>(store_.entity[i])->get_frozen()) {
+			continue;
+		}
+		// It stays exactly where it is until it wakes up
+		store_.Gather(i);
+		asleep_[i] = true;
+		changed = true;
+	}
+	if (changed) {
+		SortSleeping();
+	}
+}
+
+/**
+ * @brief Recompute awake_ and sleeping_ from asleep_ and in_play_.
+ */
+void Arena::SortSleeping(void) {
+	awake_.clear();
+	sleeping_.clear();
+	for (unsigned int i = 0; i < store_.size(); ++i) {
+		if (!store_.mobile(i) || !in_play_[i]) {
+			continue;
+		}
+		if (asleep_[i]) {
+			sleeping_.push_back(i);
+		}
+		else {
+			awake_.push_back(i);
+		}
+	}
+	sleeping_changed_ = true;
+}
+
+/**
+ * @brief Split the slots [0, n) into one contiguous range per worker and run fn
+ * on each range, in parallel.
+ * @param n Number of slots
+ * @param fn Called with the worker and the first and one past the last slot of
+ * its range
+ */
+void Arena::ParallelFor(size_t n,
+                        const std::function<void(unsigned int, size_t, size_t)>& fn) {
+	unsigned int n_workers = workers_.size();
+	workers_.Run([n, n_workers, &fn](unsigned int t) {
+		fn(t, n * t / n_workers, n * (t + 1) / n_workers);
+	});
 }
 
 /**
@@ -203,8 +743,9 @@ int Arena::UpdatePlayerTimestep(EventCollision * const ec) {
 	 * If pause time is positive, the player is frozen and thus should not move
 	 */
 	if (player_->get_pause_time() > 0) {
-		player_->set_speed(0);
-		player_->set_pause_time(player_->get_pause_time() - 1);
+		store_.set_speed(player_slot_, 0);
+		player_->set_pause_time(std::max(player_->get_pause_time() -
+		                                 static_cast<int>(timestep_), 0));
 	}
 
 	/*
@@ -213,11 +754,9 @@ int Arena::UpdatePlayerTimestep(EventCollision * const ec) {
 	 * robot away from these "obstacles" before the "collisions" have been
 	 * properly processed.
 	 */
-	CheckForEntityCollision(player_, recharge_station_, &ec,
-	                        player_->get_collision_delta(),
-	                        player_->get_heading_angle());
+	CheckForEntityCollision(player_slot_, recharge_station_slot_, ec);
 
-	if (ec.collided()) {
+	if (ec->collided()) {
 		EventRecharge er;
 		player_->Accept(&er);
 	}
@@ -229,92 +768,199 @@ int Arena::UpdatePlayerTimestep(EventCollision * const ec) {
  * @brief Update HomeBase heading angle for a single timestep
  */
 void Arena::UpdateHomebaseTimestep(void) {
-	// Randomly update homebase's heading angle
-	int random_number1;
-	random_number1 = rand() % 37;
+	// Randomly update homebase's heading angle, with the same chance each
+	// timestep of the tick
+	for (unsigned int step = 0; step < timestep_; ++step) {
+		int random_number1;
+		random_number1 = random_.Uniform(37);
 
-	// If random number is one, change heading angle of homebase to random angle
-	if (random_number1 == 1) {
-		int random_heading;
-		random_heading = rand() % 360;
-		home_base_->set_heading_angle(random_heading);
+		// If random number is one, change heading angle of homebase to random angle
+		if (random_number1 == 1) {
+			int random_heading;
+			random_heading = random_.Uniform(360);
+			store_.set_heading(home_base_slot_, random_heading);
+		}
 	}
 }
 
 /**
  * @brief Checks if a robot has collided with HomeBase and switches them to a Superbot if so
- * @param ent The entity to check.
+ * @param i Slot of the robot to check.
  * @param ec Pointer to a collision event.
  * @return int Boolean to show if HomeBase collision occured
  */
-int Arena::CheckForRobotHomeBaseCollision(Robot * ent, EventCollision * const ec) {
-	CheckForEntityCollision(ent, home_base_, &ec,
-	                        ent->get_collision_delta(),
-	                        ent->get_heading_angle());
-	if ( ec.collided() ) {
+int Arena::CheckForRobotHomeBaseCollision(unsigned int i, EventCollision * const ec) {
+	CheckForEntityCollision(i, home_base_slot_, ec);
+	if ( ec->collided() ) {
 		/*
-		 * When robot collides with homebase, move robot out of gameplay arena
-		 * and replace with a superbot at that location. Add superbot to
-		 * entities_ and mobile_entities_ and remove the robot.
+		 * When robot collides with homebase, take the robot out of play and
+		 * replace it with a superbot at that location. The superbot comes into
+		 * play in a slot after every robot and every superbot promoted before
+		 * it, so the passes after the robot pass see it there.
 		 */
-		superbot_entities_[n_superbots_]->set_pos(ent->get_pos());
-		superbot_entities_[n_superbots_]->
-		set_heading_angle(ent->get_heading_angle());
-		superbot_entities_[n_superbots_]->set_speed(ent->get_speed());
-		entities_.push_back(superbot_entities_[n_superbots_]);
-		mobile_entities_.push_back(superbot_entities_[n_superbots_]);
-		ent->set_pos(Position(1050, 860)); // move to off screen
+		Robot * ent = static_cast<Robot*>(store_.entity[i]);
+		SuperBot * sb = superbot_entities_[n_superbots_];
+		sb->set_pos(ent->get_pos());
+		sb->set_heading_angle(ent->get_heading_angle());
+		sb->set_speed(ent->get_speed());
 		ent->set_super(1);
-		entities_.erase(std::remove(entities_.begin(), entities_.end(), ent),
-		                entities_.end());
-		mobile_entities_.erase(std::remove(mobile_entities_.begin(),
-		                                   mobile_entities_.end(), ent), mobile_entities_.end());
+		PlaceRobot(i - first_robot_slot_, sb);
+		SetInPlay(i, false);
+		SetInPlay(first_superbot_slot_ + n_superbots_, true);
 		n_superbots_++;
-		break;
 	}
 
-	return ec.collided();
+	return ec->collided();
 }
 
 /**
  * @brief Checks if a robot has collided with player and freezes robot if so
- * @param ent The entity to check.
+ * @param i Slot of the robot to check.
  * @param ec Pointer to a collision event.
  */
-void Arena::CheckForRobotPlayerCollision(Robot * ent, EventCollision * const ec) {
+void Arena::CheckForRobotPlayerCollision(unsigned int i, EventCollision * const ec) {
 	// When robot collides with player, robot freezes.
-	CheckForEntityCollision(ent, player_, &ec,
-	                        ent->get_collision_delta(),
-	                        ent->get_heading_angle());
-	if ( ec.collided() ) {
-		ent->set_speed(0);
-		ent->set_frozen(1);
+	CheckForEntityCollision(i, player_slot_, ec);
+	if ( ec->collided() ) {
+		store_.set_speed(i, 0);
+		static_cast<Robot*>(store_.entity[i])->set_frozen(1);
 	}
 }
 
 /**
  * @brief Checks if a robot has collided another robot and unfreezes robot if it is frozen
- * @param ent The entity to check.
+ * @param i Slot of the robot or superbot to check.
  * @param ec Pointer to a collision event.
  */
-void Arena::CheckForRobotRobotCollision(Robot * ent, EventCollision * const ec) {
-	// Check for all other robot collisions
-	if ( !ec.collided() ) {
-		for (size_t i = 0; i < robot_entities_.size(); ++i) {
-			if (robot_entities_[i] == ent) {
+void Arena::CheckForRobotRobotCollision(unsigned int i, EventCollision * const ec) {
+	// Check for all other robot collisions, found by FindRobotCollisions()
+	if ( !ec->collided() ) {
+		const contact& c = contacts_[i];
+		const std::vector<contact_record>& hits = scratch_[c.thread].contacts;
+		for (unsigned int k = c.first_hit; k < c.end_hit; ++k) {
+			unsigned int j = hits[k].b;
+			// Robots promoted earlier in the pass are out of play
+			if (!in_play_[j] || GetInteraction(store_.type[i], store_.type[j]).collision !=
+			    kCollisionUnfreeze) {
 				continue;
 			}
-			CheckForEntityCollision(ent, robot_entities_[i], &ec,
-			                        ent->get_collision_delta(),
-			                        ent->get_heading_angle());
-			if (ec.collided()) {
-				robot_entities_[i]->set_frozen(0);
-				robot_entities_[i]->set_speed(5);
-				break;
+			ec->angle_of_contact(hits[k].angle);
+			ec->collided(1);
+			static_cast<Robot*>(store_.entity[j])->set_frozen(0);
+			store_.set_speed(j, 5);
+			if (asleep_[j]) {
+				unfrozen_.push_back(j);
 			}
+			break;
 		}
 	}
-	ent->Accept(&ec);
+	static_cast<ArenaMobileEntity*>(store_.entity[i])->Accept(ec);
+}
+
+/**
+ * @brief Find the robots each robot or superbot of a type has collided with,
+ * for CheckForRobotRobotCollision(), in parallel.
+ * @param type Type of entity to check (kRobot or kSuperBot)
+ */
+void Arena::FindRobotCollisions(enum entity_type type) {
+	/*
+	 * Nothing moves while robots are checked against each other, so every
+	 * hit can be found up front. Robots promoted while the hits are applied
+	 * are skipped then.
+	 */
+	ParallelFor(awake_.size(), [this, type](unsigned int t, size_t begin,
+	                                        size_t end) {
+		worker_scratch& scratch = scratch_[t];
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = awake_[k];
+			if (store_.type[i] != type) {
+				continue;
+			}
+			contact& c = contacts_[i];
+			c.thread = t;
+			c.first_hit = scratch.contacts.size();
+			QueryEntities(t, store_.x[i], store_.y[i],
+			              store_.radius[i] + store_.collision_delta[i] + 2 * max_step_,
+			              0);
+			for (auto j : scratch.candidates) {
+				contact_record rec;
+				if (j == i || GetInteraction(type, store_.type[j]).collision !=
+				    kCollisionUnfreeze) {
+					continue;
+				}
+				if (TestCollision(i, j, store_.x[j], store_.y[j], &rec)) {
+					rec.a = i;
+					rec.b = j;
+					rec.kind = kContactUnfreeze;
+					scratch.contacts.push_back(rec);
+				}
+			}
+			c.end_hit = scratch.contacts.size();
+		}
+	});
+}
+
+/**
+ * @brief Find the wall or other entities each mobile entity has collided with,
+ * for the general collision pass, in parallel.
+ */
+void Arena::FindCollisions(void) {
+	// Walls first: every entity out of bounds is pushed back before the
+	// entities after it are checked
+	ParallelFor(awake_.size(), [this](unsigned int t, size_t begin, size_t end) {
+		worker_scratch& scratch = scratch_[t];
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = awake_[k];
+			contact_record rec;
+			CheckForEntityOutOfBounds(i, &contacts_[i], &rec);
+			if (contacts_[i].wall) {
+				scratch.contacts.push_back(rec);
+			}
+		}
+	});
+
+	/*
+	 * Then everything else. In slot order, entity i sees the entities before
+	 * it where the walls pushed them back to, and the ones after it where they
+	 * were. Every entity it ran into is recorded, though only the first one is
+	 * bounced off.
+	 */
+	ParallelFor(awake_.size(), [this](unsigned int t, size_t begin, size_t end) {
+		worker_scratch& scratch = scratch_[t];
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = awake_[k];
+			contact& c = contacts_[i];
+			c.thread = t;
+			c.first_hit = c.end_hit = scratch.contacts.size();
+			if (c.wall) {
+				continue;
+			}
+			// Entities before this one may have been pushed back from a wall
+			// since the grid was built.
+			QueryEntities(t, store_.x[i], store_.y[i],
+			              store_.radius[i] + store_.collision_delta[i] +
+			              kWallPushback + 2 * max_step_, 0);
+			for (auto j : scratch.candidates) {
+				if (j == i) {
+					continue;
+				}
+				double x_j = store_.x[j];
+				double y_j = store_.y[j];
+				if (j < i && contacts_[j].wall) {
+					x_j = contacts_[j].pushed.x();
+					y_j = contacts_[j].pushed.y();
+				}
+				contact_record rec;
+				if (TestCollision(i, j, x_j, y_j, &rec)) {
+					rec.a = i;
+					rec.b = j;
+					rec.kind = kContactEntity;
+					scratch.contacts.push_back(rec);
+				}
+			}
+			c.end_hit = scratch.contacts.size();
+		}
+	});
 }
 
 /**
@@ -324,29 +970,41 @@ void Arena::CheckForRobotRobotCollision(Robot * ent, EventCollision * const ec)
 void Arena::UpdateRobotsTimestep(EventCollision * const ec) {
 	// Check robot entities for collisions with various entities and
 	// perform necessary functionality.
-	for (auto ent : robot_entities_) {
-		if (CheckForRobotHomeBaseCollision(ent, &ec)) {
-			break;
+	FindRobotCollisions(kRobot);
+	bool promoted = false;
+	for (auto i : awake_) {
+		// Robots promoted earlier in this pass are out of play
+		if (store_.type[i] != kRobot || !in_play_[i]) {
+			continue;
+		}
+
+		if (CheckForRobotHomeBaseCollision(i, ec)) {
+			promoted = true;
+			continue;
 		}
 
-		CheckForRobotPlayerCollision(ent, &ec);
-		CheckForRobotRobotCollision(ent, &ec);
+		CheckForRobotPlayerCollision(i, ec);
+		CheckForRobotRobotCollision(i, ec);
+	}
+
+	// The superbots promoted in this pass take part in everything after it
+	if (promoted) {
+		SortSleeping();
+		RebuildEntityGrid();
 	}
 }
 
 /**
  * @brief Checks if a superbot has collided a player and pauses player if so
- * @param ent The entity to check.
+ * @param i Slot of the superbot to check.
  * @param ec Pointer to a collision event.
  */
-void Arena::CheckForSuperbotPlayerCollision(Robot * ent, EventCollision * const ec) {
+void Arena::CheckForSuperbotPlayerCollision(unsigned int i, EventCollision * const ec) {
 	// Player collisions with superbots yield a frozen player.
-	CheckForEntityCollision(ent, player_, &ec,
-	                        ent->get_collision_delta(),
-	                        ent->get_heading_angle());
-	if ( ec.collided() ) {
+	CheckForEntityCollision(i, player_slot_, ec);
+	if ( ec->collided() ) {
 		player_->set_pause_time(100);
-		player_->set_speed(0);
+		store_.set_speed(player_slot_, 0);
 	}
 }
 
@@ -357,41 +1015,103 @@ void Arena::CheckForSuperbotPlayerCollision(Robot * ent, EventCollision * const
 void Arena::UpdateSuperbotsTimestep(EventCollision * const ec) {
 	// Next, check superbot entities for collisions with various entities and
 	// perform necessary functionality.
-	for (auto ent : superbot_entities_) {
-		CheckForSuperbotPlayerCollision(ent, &ec);
+	FindRobotCollisions(kSuperBot);
+	for (auto i : awake_) {
+		if (store_.type[i] != kSuperBot) {
+			continue;
+		}
+		CheckForSuperbotPlayerCollision(i, ec);
 
-		CheckForRobotRobotCollision(ent, &ec);
+		CheckForRobotRobotCollision(i, ec);
 	}
 }
 
 /**
- * @brief Checks if robot or superbot is in proximity of another entity and trigger proximity event if so
- * @param rob Robot or Superbot
- * @param ent Entity that may be in proximity of Robot
- * @param ep Pointer to a proximity event
- * @param et Pointer to entity type event
- * @param ed Pointer to distress event
+ * @brief Checks if robot or superbot is in proximity of another entity and
+ * records what its sensor picks up in sensed_
+ * @param i Slot of the robot or superbot
+ * @param t Worker running the check
  * @param range Range between two entites to trigger proximity event
  */
-void Arena::CheckForProximityEvent(const class Robot* const rob,
-					   class ArenaEntity* ent, EventProximity * const ep,
-						   EventEntityType * const et, EventDistress * const ed, double range) {
-
-	CheckForWallInProximity(ent, &ep, &et, ent->get_proximity_range());
-	if (!ep.activated()) {
-		for (size_t i = 0; i < entities_.size(); ++i) {
-			if (entities_[i] == ent) {
+void Arena::CheckForProximityEvent(unsigned int i, unsigned int t, double range) {
+	sensed * s = &sensed_[i];
+	s->type = kNone;
+	s->distress = false;
+	CheckForWallInProximity(i, range, s);
+	if (!s->activated) {
+		// The grid was bucketed before the general collision pass, which can
+		// move entities back along their paths and push them back from the
+		// walls.
+		QueryEntities(t, store_.x[i], store_.y[i], store_.radius[i] + range,
+		              kWallPushback + max_step_);
+		for (auto j : scratch_[t].candidates) {
+			if (j == i) {
 				continue;
 			}
-			CheckForEntityInProximity(ent, entities_[i], &ep, &et, &ed,
-			                          ent->get_proximity_range());
-			if (ep.activated()) {
+			CheckForEntityInProximity(i, j, range, s);
+			if (s->activated) {
 				break;
 			}
 		}
 	}
-	ent->Accept(&ep);
-	ent->Accept(&et);
+}
+
+/**
+ * @brief Check every robot and superbot for entities in proximity, in
+ * parallel.
+ */
+void Arena::SenseProximity(void) {
+	// Test against where the entities are now, after the collision pass
+	ParallelFor(entity_grid_.size(), [this](__unused unsigned int t, size_t begin,
+	                                        size_t end) {
+		entity_grid_.Refresh(store_.x.data(), store_.y.data(), begin, end);
+	});
+
+	// Sensing doesn't change anything the other robots sense, so all of them
+	// can look around at once.
+	ParallelFor(awake_.size(), [this](unsigned int t, size_t begin, size_t end) {
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = awake_[k];
+			if (store_.type[i] == kRobot) {
+				CheckForProximityEvent(i, t,
+				                       static_cast<Robot*>(store_.entity[i])->get_proximity_range());
+			}
+			else if (store_.type[i] == kSuperBot) {
+				CheckForProximityEvent(i, t,
+				                       static_cast<SuperBot*>(store_.entity[i])->get_proximity_range());
+			}
+		}
+	});
+}
+
+/**
+ * @brief Trigger the proximity events a robot or superbot sensed.
+ * @param i Slot of the robot or superbot
+ * @param ep Pointer to a proximity event
+ * @param et Pointer to entity type event
+ * @param ed Pointer to distress event
+ */
+void Arena::ApplyProximity(unsigned int i, EventProximity * const ep,
+                           EventEntityType * const et, EventDistress * const ed) {
+	// The events are shared by all robots, so fields that weren't sensed keep
+	// what the previous robot left in them.
+	const sensed& s = sensed_[i];
+	if (s.wall) {
+		ep->point_of_contact(s.point);
+	}
+	if (s.activated) {
+		ep->angle_of_contact(s.angle);
+	}
+	ep->activated(s.activated);
+	if (s.type != kNone) {
+		et->activated(s.type);
+	}
+	if (s.distress) {
+		ed->collided(1);
+	}
+	Robot * rob = static_cast<Robot*>(store_.entity[i]);
+	rob->Accept(ep);
+	rob->Accept(et);
 }
 
 /*
@@ -436,13 +1156,24 @@ int Arena::UpdateEntitiesTimestep(void) {
 
 	// First, update the position of all entities, according to their current
 	// velocities.
-	for (auto ent : entities_) {
-		ent->TimestepUpdate(1);
+	contacts_.resize(store_.size());
+	sensed_.resize(store_.size());
+	for (auto& scratch : scratch_) {
+		scratch.contacts.clear();
+	}
+	MoveEntities(timestep_);
+	RebuildEntityGrid();
+
+	// Anything that ran into a sleeping robot wakes it up, so it takes part in
+	// the collisions below like any other
+	if (WakeTouchedEntities()) {
+		RebuildEntityGrid();
 	}
 
 	// Checks players battery level. Updates the players pause status, and battery level
 	game_status = UpdatePlayerTimestep(&ec);
 	if (game_status != 2) {
+		RecordTrajectory();
 		return game_status;
 	}
 
@@ -457,10 +1188,16 @@ int Arena::UpdateEntitiesTimestep(void) {
 	 * When something collides with an immobile entity, the immobile entity does
 	 * not move (duh), so no need to send it a collision event.
 	 */
-	for (auto ent : mobile_entities_) {
+	FindCollisions();
+	for (auto i : awake_) {
 		// Check if entity is out of bounds. If so, use that as point of contact.
-		CheckForEntityOutOfBounds(ent, &ec);
-
+		const contact& c = contacts_[i];
+		if (c.wall) {
+			ec.collided(true);
+			ec.point_of_contact(c.point);
+			ec.angle_of_contact(c.angle);
+			store_.set_pos(i, c.pushed);
+		}
 		// If not at wall, check if it is colliding with any other entities (not
 		// itself)
 		/**
@@ -468,20 +1205,21 @@ int Arena::UpdateEntitiesTimestep(void) {
 		 * thus causing entities to "stick" to each other.
 		 * Walls and immobile entites are not checked above. besides player/rechargestation
 		 */
-		if (!ec.collided()) {
-			for (size_t i = 0; i < entities_.size(); ++i) {
-				if (entities_[i] == ent) {
-					continue;
-				}
-				CheckForEntityCollision(ent, entities_[i], &ec,
-				                        ent->get_collision_delta(),
-				                        ent->get_heading_angle());
-				if (ec.collided()) {
-					break;
-				}
+		else if (c.first_hit != c.end_hit) {
+			const contact_record& h = scratch_[c.thread].contacts[c.first_hit];
+			ec.angle_of_contact(h.angle);
+			ec.collided(1);
+			// If it went through the other entity, back up to where they first
+			// touched
+			if (h.time < 1) {
+				store_.set_pos(i, Position(Lerp(store_.start_x[i], store_.x[i], h.time),
+				                           Lerp(store_.start_y[i], store_.y[i], h.time)));
 			}
 		}
-		ent->Accept(&ec);
+		else {
+			ec.collided(false);
+		}
+		static_cast<ArenaMobileEntity*>(store_.entity[i])->Accept(&ec);
 	}
 
 	/*
@@ -489,9 +1227,11 @@ int Arena::UpdateEntitiesTimestep(void) {
 	 * of the way of incoming entities. This checks if robots are in proximity to
 	 * any entities
 	 */
-	for (auto ent : robot_entities_) {
-		CheckForProximityEvent(ent, entities_[i], &ep, &et, &ed,
-		                       ent->get_proximity_range());
+	SenseProximity();
+	for (auto i : awake_) {
+		if (store_.type[i] == kRobot) {
+			ApplyProximity(i, &ep, &et, &ed);
+		}
 	}
 
 	/*
@@ -499,105 +1239,242 @@ int Arena::UpdateEntitiesTimestep(void) {
 	 * of the way of incoming entities. This checks if superbots are in proximity to
 	 * any entities
 	 */
-	for (auto ent : superbot_entities_) {
-		CheckForProximityEvent(ent, entities_[i], &ep, &et, &ed,
-		                       ent->get_proximity_range());
+	for (auto i : awake_) {
+		if (store_.type[i] == kSuperBot) {
+			ApplyProximity(i, &ep, &et, &ed);
+		}
 	}
 
+	// Frozen robots that nothing is touching go to sleep until something runs
+	// into them
+	UpdateSleeping();
+
 	/*
 	 * Checks to see if all robots are frozen or collided with homebase.
 	 * If all are frozen or super, player wins. If all robots are super, player
 	 * loses.
 	 */
 	game_status = AllRobotsSuperOrFrozen();
+	RecordTrajectory();
 	return game_status;
 }
 
+/**
+ * @brief Hand where every mobile entity is at the end of the tick to the
+ * trajectory recorder, if there is one.
+ */
+void Arena::RecordTrajectory(void) {
+	if (!trajectory_) {
+		return;
+	}
+	struct trajectory_frame * frame = trajectory_->AcquireFrame();
+	frame->tick = ticks_;
+	auto record = [frame](size_t k, const ArenaMobileEntity * ent,
+	                      uint8_t flags) {
+		frame->x[k] = static_cast<int32_t>(ent->get_pos().x());
+		frame->y[k] = static_cast<int32_t>(ent->get_pos().y());
+		frame->heading[k] = ent->get_heading_angle();
+		frame->speed[k] = ent->get_speed();
+		frame->flags[k] = flags;
+	};
+	record(0, player_, player_->get_pause_time() > 0 ? kTrajectoryPaused : 0);
+	record(1, home_base_, 0);
+	ParallelFor(n_robots_, [this, &record](__unused unsigned int t,
+	                                       size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			uint8_t flags;
+			if (robot_view_[i]->get_type() == kSuperBot) {
+				SuperBot * s = static_cast<SuperBot*>(robot_view_[i]);
+				flags = kTrajectorySuperBot | (s->get_frozen() ? kTrajectoryFrozen : 0);
+				record(2 + i, s, flags);
+			}
+			else {
+				Robot * r = robot_view_[i];
+				flags = r->get_frozen() ? kTrajectoryFrozen : 0;
+				record(2 + i, r, flags);
+			}
+		}
+	});
+	trajectory_->SubmitFrame(frame);
+}
+
 /**
  * @brief Determine if a particular entity is gone out of the boundaries of
  * the simulation.
- * @param ent The entity to check.
- * @param event Pointer to a collision event.
-
- * Collision event is populated appropriately.
+ *
+ * When a tick covers more than one timestep, an entity that went out is
+ * pushed back from where it first reached the wall during the tick, however
+ * far past the wall it ended up. Otherwise it is pushed back from where it
+ * ended up.
+ *
+ * @param i Slot of the entity to check.
+ * @param c Contact of the entity, populated appropriately.
+ * @param rec Set to the contact with the wall if the entity reached one
  */
-void Arena::CheckForEntityOutOfBounds(ArenaMobileEntity * ent,
-                                      EventCollision * const event) {
-	double ent_x = ent->get_pos().x();
-	double ent_y = ent->get_pos().y();
-	// Angle of reflection should be 180-heading for walls
+void Arena::CheckForEntityOutOfBounds(unsigned int i, contact * const c,
+                                      contact_record * const rec) const {
+	double start_x = store_.start_x[i];
+	double start_y = store_.start_y[i];
+	double ent_x = store_.x[i];
+	double ent_y = store_.y[i];
+	double radius = store_.radius[i];
+	double heading = store_.heading[i];
+	bool swept = timestep_ > 1;
+	double t;
+	// Angle of reflection should be 180-heading for walls. Walls are straight,
+	// so an entity that ends the tick inside never left. In a long tick, one
+	// that ends further past a wall than the push back would leave it is
+	// pushed back from where along its path it reached the wall instead.
 	// Right Wall
-	if (ent->get_pos().x() + ent->get_radius() >= x_dim_) {
-		event->collided(true);
-		event->point_of_contact(Position(x_dim_, ent->get_pos().y()));
-		event->angle_of_contact(-((360 - ent->get_heading_angle()) + 180));
-		ent->set_pos(Position(ent_x - 10, ent_y));
-	}
-	else if (ent->get_pos().x() - ent->get_radius() <= 0) { // Left Wall
-		event->collided(true);
-		event->point_of_contact(Position(0, ent->get_pos().y()));
-		event->angle_of_contact(-((360 - ent->get_heading_angle()) + 180));
-		ent->set_pos(Position(ent_x + 10, ent_y));
-	}
-	else if (ent->get_pos().y() + ent->get_radius() >= y_dim_) { // Bottom Wall
-		event->collided(true);
-		event->point_of_contact(Position(ent->get_pos().x(), y_dim_));
-		event->angle_of_contact(ent->get_heading_angle());
-		ent->set_pos(Position(ent_x, ent_y - 10));
-	}
-	else if (ent->get_pos().y() - ent->get_radius() <= 0) { // Top Wall
-		event->collided(true);
-		event->point_of_contact(Position(0, y_dim_));
-		event->angle_of_contact(ent->get_heading_angle());
-		ent->set_pos(Position(ent_x, ent_y + 10));
+	if (ent_x + radius >= x_dim_) {
+		t = !swept || ent_x + radius - x_dim_ <= kWallPushback ? 1 :
+			TimeToReach(start_x, ent_x, x_dim_ - radius);
+		c->wall = true;
+		c->point = Position(x_dim_, Lerp(start_y, ent_y, t));
+		c->angle = -((360 - heading) + 180);
+		c->pushed = Position(Lerp(start_x, ent_x, t) - kWallPushback,
+		                     Lerp(start_y, ent_y, t));
+		rec->normal_x = 1;
+		rec->depth = ent_x + radius - x_dim_;
+	}
+	else if (ent_x - radius <= 0) { // Left Wall
+		t = !swept || radius - ent_x <= kWallPushback ? 1 :
+			TimeToReach(start_x, ent_x, radius);
+		c->wall = true;
+		c->point = Position(0, Lerp(start_y, ent_y, t));
+		c->angle = -((360 - heading) + 180);
+		c->pushed = Position(Lerp(start_x, ent_x, t) + kWallPushback,
+		                     Lerp(start_y, ent_y, t));
+		rec->normal_x = -1;
+		rec->depth = radius - ent_x;
+	}
+	else if (ent_y + radius >= y_dim_) { // Bottom Wall
+		t = !swept || ent_y + radius - y_dim_ <= kWallPushback ? 1 :
+			TimeToReach(start_y, ent_y, y_dim_ - radius);
+		c->wall = true;
+		c->point = Position(Lerp(start_x, ent_x, t), y_dim_);
+		c->angle = heading;
+		c->pushed = Position(Lerp(start_x, ent_x, t),
+		                     Lerp(start_y, ent_y, t) - kWallPushback);
+		rec->normal_y = 1;
+		rec->depth = ent_y + radius - y_dim_;
+	}
+	else if (ent_y - radius <= 0) { // Top Wall
+		t = !swept || radius - ent_y <= kWallPushback ? 1 :
+			TimeToReach(start_y, ent_y, radius);
+		c->wall = true;
+		c->point = Position(0, y_dim_);
+		c->angle = heading;
+		c->pushed = Position(Lerp(start_x, ent_x, t),
+		                     Lerp(start_y, ent_y, t) + kWallPushback);
+		rec->normal_y = -1;
+		rec->depth = radius - ent_y;
 	}
 	else {
-		event->collided(false);
+		c->wall = false;
+		return;
 	}
+	rec->a = i;
+	rec->b = kWallSlot;
+	rec->kind = kContactWall;
+	rec->angle = c->angle;
+	rec->time = t;
 }
 
 /**
  * @brief Determine if two entities have collided in the arena. Collision is
  * defined as the difference between the extents of the two entities being less
- * than a run-time parameter.
+ * than a run-time parameter (the collision delta of entity #1).
  *
- * @param ent1 Entity #1.
- * @param ent2 Entity #2.
+ * @param i Slot of entity #1.
+ * @param j Slot of entity #2.
  * @param event Pointer to a collision event
- * @param collision_delta Buffer for collisions
- * @param h_angle The heading angle of entity #1
  *
  * Collision Event is populated appropriately.
  */
-void Arena::CheckForEntityCollision(const ArenaEntity* const ent1,
-                                    const ArenaEntity* const ent2, EventCollision * const event,
-                                    double collision_delta, double h_angle) {
-	/* Note: this assumes circular entities */
-	double ent1_x = ent1->get_pos().x();
-	double ent1_y = ent1->get_pos().y();
-	double ent2_x = ent2->get_pos().x();
-	double ent2_y = ent2->get_pos().y();
-	double dist = std::sqrt(std::pow(ent2_x - ent1_x, 2) +
-	                        std::pow(ent2_y - ent1_y, 2));
-	if (dist > ent1->get_radius() + ent2->get_radius() + collision_delta) {
-		event->collided(0);
+void Arena::CheckForEntityCollision(unsigned int i, unsigned int j,
+                                    EventCollision * const event) {
+	contact_record rec;
+	if (TestCollision(i, j, store_.x[j], store_.y[j], &rec)) {
+		event->angle_of_contact(rec.angle);
+		event->collided(1);
 	}
 	else {
-		// Populate the collision event.
-		// Collided is true
-		// Point of contact is point along perimeter of ent1
-		// Angle of contact is angle to that point of contact
-		// TODO: fix collision logic.
-		double adj = ent2_x - ent1_x;
-		double opp = ent2_y - ent1_y;
-		double angle = atan(opp / adj) * (180/3.14159265);
-		double bounce_angle = angle + 90;
-		double adjusted_angle = (180 - bounce_angle) + (h_angle - 180);
-		double new_head = bounce_angle - adjusted_angle;
-
-		event->angle_of_contact(-new_head);
-		event->collided(1);
+		event->collided(0);
+	}
+}
+
+/**
+ * @brief Determine if two entities have collided at any point during the
+ * tick, with entity #2 ending the tick at a given position.
+ *
+ * When a tick covers more than one timestep, both entities are taken to move
+ * in a straight line from where they started the tick, so entities that passed
+ * through each other within the tick still collide. Otherwise only where they
+ * ended up counts.
+ *
+ * @param i Slot of entity #1.
+ * @param j Slot of entity #2.
+ * @param x_j The x coordinate of entity #2
+ * @param y_j The y coordinate of entity #2
+ * @param rec Set to the normal, depth, angle and time of the contact if they
+ * have collided; its slots and kind are left to the caller
+ * @return bool Whether they have collided
+ */
+bool Arena::TestCollision(unsigned int i, unsigned int j, double x_j, double y_j,
+                          contact_record * const rec) const {
+	/* Note: this assumes circular entities */
+	// Entity #2 relative to entity #1 at the start of the tick, and how that
+	// changes over the tick
+	double dx = store_.start_x[j] - store_.start_x[i];
+	double dy = store_.start_y[j] - store_.start_y[i];
+	double vx = (x_j - store_.start_x[j]) - (store_.x[i] - store_.start_x[i]);
+	double vy = (y_j - store_.start_y[j]) - (store_.y[i] - store_.start_y[i]);
+	double reach = store_.radius[i] + store_.radius[j] + store_.collision_delta[i];
+
+	double t = 1;
+	double end_dx = x_j - store_.x[i];
+	double end_dy = y_j - store_.y[i];
+	if (end_dx * end_dx + end_dy * end_dy > reach * reach) {
+		// Entities only move a few pixels in a single timestep, so only a
+		// tick covering more than one is swept
+		if (timestep_ == 1) {
+			return false;
+		}
+		// Apart at the end of the tick, but they may have passed through each
+		// other on the way: find the first t in [0, 1] at which
+		// |d + t v| <= reach, if any
+		double c = dx * dx + dy * dy - reach * reach;
+		double a = vx * vx + vy * vy;
+		double b = dx * vx + dy * vy;
+		double disc = b * b - a * c;
+		if (c <= 0 || b >= 0 || disc < 0) { // separated, moving apart, or passing wide
+			return false;
+		}
+		t = (-b - std::sqrt(disc)) / a;
+		if (t >= 1) {
+			return false;
+		}
 	}
+	rec->time = t;
+
+	// Angle of contact is angle to the point of contact along the perimeter
+	// of entity #1
+	// TODO: fix collision logic.
+	double adj = t < 1 ? dx + vx * t : end_dx;
+	double opp = t < 1 ? dy + vy * t : end_dy;
+	double angle_to = atan(opp / adj) * (180/3.14159265);
+	double bounce_angle = angle_to + 90;
+	double adjusted_angle = (180 - bounce_angle) + (store_.heading[i] - 180);
+	double new_head = bounce_angle - adjusted_angle;
+	rec->angle = -new_head;
+
+	// Entities that passed through each other touch at exactly their reach
+	double dist = t < 1 ? reach : std::sqrt(adj * adj + opp * opp);
+	rec->normal_x = dist > 0 ? adj / dist : 0;
+	rec->normal_y = dist > 0 ? opp / dist : 0;
+	rec->depth = reach - dist;
+	return true;
 }
 
 /**
@@ -605,52 +1482,44 @@ void Arena::CheckForEntityCollision(const ArenaEntity* const ent1,
  * Proximity is defined as the if the entities are closer than the range
  * number in the proximity sensor.
  *
- * @param rob Robot or Superbot
- * @param ent Entity that may be in proximity of Robot
- * @param ep Pointer to a proximity event
- * @param et Pointer to entity type event
- * @param ed Pointer to distress event
+ * @param i Slot of the robot or superbot
+ * @param j Slot of the entity that may be in proximity of it
  * @param range Range between two entites to trigger proximity event
- *
- * Proximity Event is populated appropriately.
- */
-void Arena::CheckForEntityInProximity(const class Robot* const rob,
-					      class ArenaEntity* ent, EventProximity * const ep,
-						      EventEntityType * const et, EventDistress * const ed, double range) {
-	double rob_x = rob->get_pos().x();
-	double rob_y = rob->get_pos().y();
-	double ent_x = ent->get_pos().x();
-	double ent_y = ent->get_pos().y();
-	double dist = std::sqrt(std::pow(ent_x - rob_x, 2) +
-	                        std::pow(ent_y - rob_y, 2));
-	if (dist > rob->get_radius() + ent->get_radius() + range) {
-		ep->activated(0);
+ * @param s What the sensor picks up, populated appropriately.
+ */
+void Arena::CheckForEntityInProximity(unsigned int i, unsigned int j,
+                                      double range, sensed * const s) const {
+	double rob_x = store_.x[i];
+	double rob_y = store_.y[i];
+	double ent_x = store_.x[j];
+	double ent_y = store_.y[j];
+	double dx = ent_x - rob_x;
+	double dy = ent_y - rob_y;
+	double reach = store_.radius[j] + (store_.radius[i] + range);
+	if (dx * dx + dy * dy > reach * reach) {
+		s->activated = false;
 	}
 	else {
-		if (ent->get_name() == "Robot") {
-			Robot* rob2 = dynamic_cast<Robot*>(ent);
-			if (!rob2->get_frozen()) { // If robot not frozen avoid
-				ep->angle_of_contact(rob->get_heading_angle());
-				ep->activated(1);
-				et->activated(kRobot);
+		switch (GetInteraction(store_.type[i], store_.type[j]).proximity) {
+		case kProximityRobot:
+			if (!static_cast<Robot*>(store_.entity[j])->get_frozen()) { // If robot not frozen avoid
+				s->angle = store_.heading[i];
+				s->activated = true;
+				s->type = kRobot;
 			}
 			else { // if robot frozen continue heading
-				ed->collided(1);
-				ep->activated(0);
+				s->distress = true;
+				s->activated = false;
 			}
-		}
-		else if ((ent->get_name() == "Home Base") && (rob->get_name() == "Robot")) { // continue heading
-			ep->activated(0);
-			et->activated(kHomebase);
-		}
-		// TODO: Make sure when rob is superbot rob->get_name() == "Superbot"
-		else if ((ent->get_name() == "Player") && (rob->get_name() == "Superbot")) { // continue heading
-			ep->activated(0);
-			et->activated(kPlayer);
-		}
-		else { // avoid
-			ep->angle_of_contact(rob->get_heading_angle());
-			ep->activated(1);
+			break;
+		case kProximityContinue: // continue heading
+			s->activated = false;
+			s->type = store_.type[j];
+			break;
+		default: // avoid
+			s->angle = store_.heading[i];
+			s->activated = true;
+			break;
 		}
 	}
 }
@@ -659,47 +1528,41 @@ void Arena::CheckForEntityInProximity(const class Robot* const rob,
  * @brief Determine if a particular robot is in proximity of the boundaries
  * of the simulation.
  *
- * @param ent The Robot to check.
- * @param event Pointer to a proximity event.
- * @param et Emits the type of entity the robot is in proximity of
+ * @param i Slot of the robot to check.
  * @param range Range in which event will trigger if entity is within
- *
- * Proximity event is populated appropriately.
- */
-void Arena::CheckForWallInProximity(class Robot* ent,
-					    EventProximity * const event, EventEntityType * const et, double range) {
-	double ent_x = ent->get_pos().x();
-	double ent_y = ent->get_pos().y();
-	if (ent->get_pos().x() + ent->get_radius() + range >= x_dim_) { // Right
-		event->activated(true);
-		et->activated(kWall);
-		event->point_of_contact(Position(x_dim_, ent->get_pos().y()));
-		event->angle_of_contact(-((360 - ent->get_heading_angle()) + 180));
-		ent->set_pos(Position(ent_x, ent_y));
-	}
-	else if (ent->get_pos().x() - ent->get_radius() - range <= 0) { // Left
-		event->activated(true);
-		et->activated(kWall);
-		event->point_of_contact(Position(0, ent->get_pos().y()));
-		event->angle_of_contact(-((360 - ent->get_heading_angle()) + 180));
-		ent->set_pos(Position(ent_x, ent_y));
-	}
-	else if (ent->get_pos().y() + ent->get_radius() + range >= y_dim_) {
-		event->activated(true);
-		et->activated(kWall);
-		event->point_of_contact(Position(ent->get_pos().x(), y_dim_));
-		event->angle_of_contact(ent->get_heading_angle());
-		ent->set_pos(Position(ent_x, ent_y));
-	}
-	else if (ent->get_pos().y() - ent->get_radius() - range <= 0) { // Top
-		event->activated(true);
-		et->activated(kWall);
-		event->point_of_contact(Position(0, y_dim_));
-		event->angle_of_contact(ent->get_heading_angle());
-		ent->set_pos(Position(ent_x, ent_y));
+ * @param s What the sensor picks up, populated appropriately.
+ */
+void Arena::CheckForWallInProximity(unsigned int i, double range,
+                                    sensed * const s) const {
+	double ent_x = store_.x[i];
+	double ent_y = store_.y[i];
+	double reach = store_.radius[i] + range;
+	double heading = store_.heading[i];
+	s->wall = true;
+	s->activated = true;
+	if (ent_x + reach >= x_dim_) { // Right
+		s->type = kWall;
+		s->point = Position(x_dim_, ent_y);
+		s->angle = -((360 - heading) + 180);
+	}
+	else if (ent_x - reach <= 0) { // Left
+		s->type = kWall;
+		s->point = Position(0, ent_y);
+		s->angle = -((360 - heading) + 180);
+	}
+	else if (ent_y + reach >= y_dim_) {
+		s->type = kWall;
+		s->point = Position(ent_x, y_dim_);
+		s->angle = heading;
+	}
+	else if (ent_y - reach <= 0) { // Top
+		s->type = kWall;
+		s->point = Position(0, y_dim_);
+		s->angle = heading;
 	}
 	else {
-		event->activated(false);
+		s->wall = false;
+		s->activated = false;
 	}
 }
 
@@ -708,6 +1571,9 @@ void Arena::CheckForWallInProximity(class Robot* ent,
  * @param key Value of a key press
  */
 void Arena::Accept(int key) {
+	if (input_log_) {
+		input_log_->Record(ticks_, key);
+	}
 	EventKeypress e(key);
 	EventCommand ec(e.keypress_to_cmd(key));
 	player_->EventCmd(ec.cmd());
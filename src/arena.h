@@ -11,14 +11,24 @@
  * Includes
  ******************************************************************************/
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <functional>
 #include "src/event_keypress.h"
 #include "src/event_collision.h"
 #include "src/player.h"
 #include "src/superbot.h"
 #include "src/sensor.h"
+#include "src/spatial_hash.h"
+#include "src/obstacle_tree.h"
+#include "src/entity_store.h"
+#include "src/entity_span.h"
+#include "src/entity_pool.h"
+#include "src/worker_pool.h"
+#include "src/random_stream.h"
+#include "src/trajectory_format.h"
 
 /*******************************************************************************
  * Namespaces
@@ -29,6 +39,8 @@ NAMESPACE_BEGIN(csci3081);
  * Class Definitions
  ******************************************************************************/
 struct arena_params;
+class InputLog;
+class TrajectoryRecorder;
 
 /**
  * @brief The main class for the simulation of a 2D world with many robots running
@@ -45,7 +57,14 @@ public:
 	~Arena(void);
 
 	/**
-	 * @brief Advance the simulation by the specified # of steps.
+	 * @brief Advance the simulation by one tick, which covers as many
+	 * timesteps as the arena_params it was built from ask for.
+	 *
+	 * Collisions are found along the whole path each entity moved during the
+	 * tick, not just where it ended up, so a tick of several timesteps still
+	 * catches every contact; only how the entities steer in between is
+	 * coarser.
+	 *
 	 * @return int Status of the game (0 = player loses, 1 = player wins, 2 = continue game)
 	 */
 	int AdvanceTime(void);
@@ -61,6 +80,81 @@ public:
 	 */
 	void Reset(void);
 
+	/**
+	 * @brief Save everything about the game in play that changes from tick to
+	 * tick as a block of bytes, so it can be picked up again from this point
+	 * with \ref Restore().
+	 *
+	 * The snapshot holds the state of the random stream, which robots have
+	 * been promoted to superbots, and the position, heading, speed, sensor
+	 * readings and flags of every player, robot and superbot. The obstacles
+	 * and anything else fixed when the arena was built are left out, so a
+	 * snapshot can only be restored into an arena built from the same
+	 * arena_params, in the same build of the program.
+	 *
+	 * @param out Set to the snapshot; its capacity is reused
+	 */
+	void Snapshot(std::vector<uint8_t> * const out) const;
+
+	/**
+	 * @brief Put the game back to the point a \ref Snapshot() was taken at.
+	 * Playing on from there gives the same game as it did the first time.
+	 * @param data First byte of the snapshot
+	 * @param size Size of the snapshot in bytes
+	 * @return bool Whether the snapshot could be restored; it can't if it was
+	 * taken of an arena with different numbers of entities, and the arena is
+	 * left as it was
+	 */
+	bool Restore(const uint8_t * data, size_t size);
+
+	/**
+	 * @brief Get a 64-bit hash of the state of the game in play: everything
+	 * \ref Snapshot() saves, including the tick count. Two arenas built from
+	 * the same arena_params hash equal when they are at the same point of the
+	 * same game.
+	 * @return uint64_t FNV-1a hash of the arena's snapshot
+	 */
+	uint64_t StateHash(void) const;
+
+	/**
+	 * @brief Record every key press and reset from now on, with the tick it
+	 * came in at, so the game can be played again with \ref ReplayInputLog().
+	 * @param log Log to record into (nullptr stops recording); the arena
+	 * doesn't own it
+	 */
+	void set_input_log(class InputLog * const log) {
+		input_log_ = log;
+	}
+
+	/**
+	 * @brief Record where every mobile entity is at the end of every tick
+	 * from now on: the player, the home base and each robot (or the superbot
+	 * it was promoted to), in the order of \ref trajectory_entities().
+	 * @param recorder Recorder to record into, opened with
+	 * trajectory_entities() (nullptr stops recording); the arena doesn't own
+	 * it
+	 */
+	void set_trajectory_recorder(class TrajectoryRecorder * const recorder) {
+		trajectory_ = recorder;
+	}
+
+	/**
+	 * @brief Get the type and id of each entity a trajectory of the arena
+	 * follows, in the order they are recorded.
+	 * @return std::vector<trajectory_entity> The player, the home base, then
+	 * each robot
+	 */
+	std::vector<struct trajectory_entity> trajectory_entities(void) const;
+
+	/**
+	 * @brief Get the number of ticks played since the arena was built, over
+	 * every game played in it.
+	 * @return uint64_t Number of calls to \ref AdvanceTime() so far
+	 */
+	uint64_t ticks(void) const {
+		return ticks_;
+	}
+
 	/**
 	 * @brief Get the # of players in the arena.
 	 * @return unsigned int Number of players in Arena
@@ -77,6 +171,31 @@ public:
 		return n_obstacles_;
 	}
 
+	/**
+	 * @brief Set the number of threads each timestep is spread across. The
+	 * outcome of every timestep is the same no matter how many are used.
+	 * @param n_threads Number of threads, including the caller (1 runs
+	 * everything on the calling thread)
+	 */
+	void set_threads(unsigned int n_threads);
+
+	/**
+	 * @brief Replace the stream all of the arena's random numbers are drawn
+	 * from, e.g. with one of several jumped apart streams of the same seed.
+	 * @param random The new stream
+	 */
+	void set_random(const RandomStream& random) {
+		random_ = random;
+	}
+
+	/**
+	 * @brief Get the number of threads each timestep is spread across.
+	 * @return unsigned int Number of threads, including the caller
+	 */
+	unsigned int threads(void) const {
+		return workers_.size();
+	}
+
 
 	/**
 	 * @brief Returns the level of the player battery.
@@ -92,23 +211,34 @@ public:
 	void home_base_change_direction(double head_angle);
 
 	/**
-	 * @brief Get a list of all obstacles (i.e. non-mobile entities in the arena).
-	 * @return std::vector<Obstacle*> A vector containing the obstacles in the arena
+	 * @brief Get a list of all obstacles (i.e. non-mobile entities in the arena,
+	 * including the recharge station).
+	 * @return EntitySpan<Obstacle> A view of the obstacles in the arena, valid
+	 * until the next AdvanceTime() or Reset()
 	 */
-	std::vector<class Obstacle*> obstacles(void);
-
+	EntitySpan<class Obstacle> obstacles(void) const {
+		return EntitySpan<class Obstacle>(obstacle_view_);
+	}
 
 	/**
-	 * @brief Get a list of all robots.
-	 * @return std::vector<Robot*> A vector containing the Robots in the arena
-	 */
-	std::vector<class Robot*> robots(void);
+	 * @brief Get a list of all robots in play, including the ones promoted to
+	 * superbots.
+	 * @return EntitySpan<Robot> A view of the Robots in the arena, valid until
+	 * the next AdvanceTime() or Reset(). A promoted robot's superbot takes its
+	 * place in the list.
+	 */
+	EntitySpan<class Robot> robots(void) const {
+		return EntitySpan<class Robot>(robot_view_);
+	}
 
 	/**
-	 * @brief Get a list of all Superbots.
-	 * @return std::vector<SuperBot*> A vector containing the Superbots in the arena
+	 * @brief Get a list of all Superbots in play.
+	 * @return EntitySpan<SuperBot> A view of the Superbots in the arena, valid
+	 * until the next AdvanceTime() or Reset()
 	 */
-	std::vector<class SuperBot*> superbots(void);
+	EntitySpan<class SuperBot> superbots(void) const {
+		return EntitySpan<class SuperBot>(superbot_view_);
+	}
 
 	/**
 	 * @brief Get the list of all mobile entities in the arena.
@@ -144,6 +274,97 @@ public:
 	}
 
 private:
+	// Times the collision, proximity and bounds checks below on their own
+	// (see arena_bench.cc)
+	friend class ArenaBench;
+
+	/**
+	 * @brief Slot given to a wall in a contact record.
+	 */
+	static const unsigned int kWallSlot = ~0u;
+
+	/**
+	 * @brief The kinds of contact found in a tick.
+	 */
+	enum contact_kind {
+		kContactWall, // an entity reached a wall
+		kContactUnfreeze, // a robot or superbot ran into a robot, for unfreezing
+		kContactEntity, // an entity ran into another, in the general pass
+	};
+
+	/**
+	 * @brief One contact found in a collision pass: an entity running into
+	 * another, or into a wall.
+	 */
+	struct contact_record {
+		contact_record(void) : a(0), b(0), kind(kContactEntity), normal_x(0),
+			normal_y(0), depth(0), angle(0), time(0) {
+		}
+
+		unsigned int a; // slot of the entity that ran into something
+		unsigned int b; // slot of what it ran into (kWallSlot for a wall)
+		enum contact_kind kind; // which pass found it, and what it is
+		double normal_x; // x component of the unit normal from a towards b
+		double normal_y; // y component of the unit normal from a towards b
+		double depth; // how far a overlaps b when they touch (0 if swept)
+		double angle; // heading a bounces off at
+		double time; // fraction of the tick at which they first touched
+	};
+
+	/**
+	 * @brief What an entity runs into in a collision pass, and where its
+	 * contacts are in the tick's contact buffer. Filled in for many entities
+	 * at once, then applied to them one at a time in slot order.
+	 */
+	struct contact {
+		contact(void) : wall(false), point(), pushed(), angle(0), thread(0),
+			first_hit(0), end_hit(0) {
+		}
+
+		bool wall; // whether the entity is out of bounds
+		Position point; // point of contact with the wall
+		Position pushed; // where the wall pushes the entity back to
+		double angle; // angle of contact with the wall
+		unsigned int thread; // worker whose contact buffer holds the entity's hits
+		unsigned int first_hit; // index of the entity's first hit in it
+		unsigned int end_hit; // one past the entity's last hit
+	};
+
+	/**
+	 * @brief What the proximity sensor of a robot or superbot picks up in a
+	 * proximity pass. Filled in for many entities at once, then applied to
+	 * them one at a time in slot order.
+	 */
+	struct sensed {
+		sensed(void) : activated(false), wall(false), distress(false), point(),
+			angle(0), type(kNone) {
+		}
+
+		bool activated; // whether something is in range to be avoided
+		bool wall; // whether a wall is in range
+		bool distress; // whether a frozen robot is in range
+		Position point; // point of contact with the wall
+		double angle; // angle of contact
+		enum entity_type type; // type of entity sensed (kNone if none)
+	};
+
+	/**
+	 * @brief Scratch space of one worker thread.
+	 */
+	struct worker_scratch {
+		worker_scratch(void) : candidates(), merged(), sleeping_candidates(),
+			obstacle_candidates(), contacts(), woken(), max_step2(0) {
+		}
+
+		std::vector<unsigned int> candidates; // broad phase results
+		std::vector<unsigned int> merged; // broad phase results being merged
+		std::vector<unsigned int> sleeping_candidates; // broad phase results from the sleeping grid
+		std::vector<unsigned int> obstacle_candidates; // broad phase results from the obstacle tree
+		std::vector<contact_record> contacts; // contacts found by the worker in the current tick
+		std::vector<unsigned int> woken; // sleeping entities found touched in the current pass
+		double max_step2; // square of the farthest the worker moved an entity this tick
+	};
+
 	/**
 	 * @brief Checks players battery level. Updates the players pause status, and
 	 * battery level for a single timestep
@@ -159,25 +380,38 @@ private:
 
 	/**
 	 * @brief Checks if a robot has collided with HomeBase and switches them to a Superbot if so
-	 * @param ent The entity to check.
+	 * @param i Slot of the robot to check.
 	 * @param ec Pointer to a collision event.
 	 * @return int Boolean to show if HomeBase collision occured
 	 */
-	int CheckForRobotHomeBaseCollision(Robot * ent, EventCollision * const ec);
+	int CheckForRobotHomeBaseCollision(unsigned int i, EventCollision * const ec);
 
 	/**
 	 * @brief Checks if a robot has collided with player and freezes robot if so
-	 * @param ent The entity to check.
+	 * @param i Slot of the robot to check.
 	 * @param ec Pointer to a collision event.
 	 */
-	void CheckForRobotPlayerCollision(Robot * ent, EventCollision * const ec);
+	void CheckForRobotPlayerCollision(unsigned int i, EventCollision * const ec);
 
 	/**
 	 * @brief Checks if a robot has collided another robot and unfreezes robot if it is frozen
-	 * @param ent The entity to check.
+	 * @param i Slot of the robot or superbot to check.
 	 * @param ec Pointer to a collision event.
 	 */
-	void CheckForRobotRobotCollision(Robot * ent, EventCollision * const ec);
+	void CheckForRobotRobotCollision(unsigned int i, EventCollision * const ec);
+
+	/**
+	 * @brief Find the robots each robot or superbot of a type has collided
+	 * with, for CheckForRobotRobotCollision(), in parallel.
+	 * @param type Type of entity to check (kRobot or kSuperBot)
+	 */
+	void FindRobotCollisions(enum entity_type type);
+
+	/**
+	 * @brief Find the wall or first other entity each mobile entity has
+	 * collided with, for the general collision pass, in parallel.
+	 */
+	void FindCollisions(void);
 
 	/**
 	 * @brief Check for robot collisions
@@ -187,10 +421,10 @@ private:
 
 	/**
 	 * @brief Checks if a superbot has collided a player and pauses player if so
-	 * @param ent The entity to check.
+	 * @param i Slot of the superbot to check.
 	 * @param ec Pointer to a collision event.
 	 */
-	void CheckForSuperbotPlayerCollision(Robot * ent, EventCollision * const ec);
+	void CheckForSuperbotPlayerCollision(unsigned int i, EventCollision * const ec);
 
 	/**
 	 * @brief Check for superbot collisions
@@ -199,17 +433,29 @@ private:
 	void UpdateSuperbotsTimestep(EventCollision * const ec);
 
 	/**
-	 * @brief Checks if robot or superbot is in proximity of another entity and trigger proximity event if so
-	 * @param rob Robot or Superbot
-	 * @param ent Entity that may be in proximity of Robot
+	 * @brief Checks if robot or superbot is in proximity of another entity
+	 * and records what its sensor picks up in sensed_
+	 * @param i Slot of the robot or superbot
+	 * @param t Worker running the check
+	 * @param range Range between two entites to trigger proximity event
+	 */
+	void CheckForProximityEvent(unsigned int i, unsigned int t, double range);
+
+	/**
+	 * @brief Check every robot and superbot for entities in proximity, in
+	 * parallel.
+	 */
+	void SenseProximity(void);
+
+	/**
+	 * @brief Trigger the proximity events a robot or superbot sensed.
+	 * @param i Slot of the robot or superbot
 	 * @param ep Pointer to a proximity event
 	 * @param et Pointer to entity type event
 	 * @param ed Pointer to distress event
-	 * @param range Range between two entites to trigger proximity event
 	 */
-	void CheckForProximityEvent(const class Robot* const rob,
-					    class ArenaEntity* ent, EventProximity * const ep,
-						    EventEntityType * const et, EventDistress * const ed, double range);
+	void ApplyProximity(unsigned int i, EventProximity * const ep,
+	                    EventEntityType * const et, EventDistress * const ed);
 
 	/*
 	 * @brief Checks to see if all robots are frozen or collided with homebase.
@@ -219,97 +465,79 @@ private:
 	 */
 	int AllRobotsSuperOrFrozen(void);
 
-	/**
-	 * @brief Check for superbot collisions
-	 * @param ec Pointer to a collision event.
-	 */
-	void UpdateSuperbotsTimestep(EventCollision * const ec);
-
 	/**
 	 * @brief Determine if two entities have collided in the arena. Collision is
 	 * defined as the difference between the extents of the two entities being less
-	 * than a run-time parameter.
+	 * than a run-time parameter (the collision delta of entity #1).
 	 *
-	 * @param ent1 Entity #1.
-	 * @param ent2 Entity #2.
+	 * @param i Slot of entity #1.
+	 * @param j Slot of entity #2.
 	 * @param event Pointer to a collision event
-	 * @param collision_delta Buffer for collisions
-	 * @param h_angle The heading angle of entity #1
 	 *
 	 * Collision Event is populated appropriately.
 	 */
-	void CheckForEntityCollision(const class ArenaEntity* const ent1,
-					     const class ArenaEntity* const ent2,
-						     EventCollision * const ec,
-						     double collision_delta, double h_angle);
+	void CheckForEntityCollision(unsigned int i, unsigned int j,
+	                             EventCollision * const ec);
 
 	/**
-	 * @brief Determine if a particular entity is gone out of the boundaries of
-	 * the simulation.
+	 * @brief Determine if two entities have collided at any point during the
+	 * tick, with entity #2 ending the tick at a given position.
 	 *
-	 * @param ent The entity to check.
-	 * @param event Pointer to a collision event.
+	 * When a tick covers more than one timestep, both entities are taken to
+	 * move in a straight line from where they started the tick, so entities
+	 * that passed through each other within the tick still collide.
+	 * Otherwise only where they ended up counts.
 	 *
-	 * Collision event is populated appropriately.
+	 * @param i Slot of entity #1.
+	 * @param j Slot of entity #2.
+	 * @param x_j The x coordinate of entity #2
+	 * @param y_j The y coordinate of entity #2
+	 * @param rec Set to the normal, depth, angle and time of the contact if
+	 * they have collided; its slots and kind are left to the caller
+	 * @return bool Whether they have collided
 	 */
-	void CheckForEntityOutOfBounds(class ArenaMobileEntity* ent,
-					       EventCollision * const ec);
+	bool TestCollision(unsigned int i, unsigned int j, double x_j, double y_j,
+	                   struct contact_record * const rec) const;
 
 	/**
-	 * @brief Determine if two entities are in proximity of one another.
-	 * Proximity is defined as the if the entities are closer than the range
-	 * number in the proximity sensor.
+	 * @brief Determine if a particular entity is gone out of the boundaries of
+	 * the simulation.
 	 *
-	 * @param rob Robot
-	 * @param ent Entity that may be in proximity of Robot
-	 * @param ep Pointer to a proximity event
-	 * @param et Pointer to entity type event
-	 * @param ed Pointer to distress event
-	 * @param range Range between two entites to trigger proximity event
+	 * When a tick covers more than one timestep, an entity that went out is
+	 * pushed back from where it first reached the wall during the tick,
+	 * however far past the wall it ended up. Otherwise it is pushed back from
+	 * where it ended up.
 	 *
-	 * Proximity Event is populated appropriately.
+	 * @param i Slot of the entity to check.
+	 * @param c Contact of the entity, populated appropriately.
+	 * @param rec Set to the contact with the wall if the entity reached one
 	 */
-	void CheckForEntityInProximity(const class Robot* const rob,
-					       class ArenaEntity* ent,
-						       EventProximity * const ep,
-						       EventEntityType * const et,
-						       EventDistress * const ed,
-						       double range);
+	void CheckForEntityOutOfBounds(unsigned int i, struct contact * const c,
+	                               struct contact_record * const rec) const;
 
 	/**
-	 * @brief Determine if a suberbot is in proximity of another entity.
+	 * @brief Determine if two entities are in proximity of one another.
 	 * Proximity is defined as the if the entities are closer than the range
 	 * number in the proximity sensor.
 	 *
-	 * @param rob Superbot
-	 * @param ent Entity that may be in proximity of Superbot
-	 * @param ep Pointer to a proximity event
-	 * @param et Pointer to entity type event
-	 * @param ed Pointer to distress event
+	 * @param i Slot of the robot or superbot
+	 * @param j Slot of the entity that may be in proximity of it
 	 * @param range Range between two entites to trigger proximity event
-	 *
-	 * Proximity Event is populated appropriately.
+	 * @param s What the sensor picks up, populated appropriately.
 	 */
-	void SuperBotCheckForEntityInProximity(const class SuperBot* const rob,
-						       class ArenaEntity* ent,
-							       EventProximity * const ep,
-							       EventEntityType * const et,
-							       EventDistress * const ed, double range);
-
+	void CheckForEntityInProximity(unsigned int i, unsigned int j, double range,
+	                               struct sensed * const s) const;
 
 	/**
 	 * @brief Determine if a particular robot is in proximity of the boundaries
 	 * of the simulation.
 	 *
-	 * @param ent The Robot to check.
-	 * @param event Pointer to a proximity event.
-	 * @param et Emits the type of entity the robot is in proximity of
+	 * @param i Slot of the robot to check.
 	 * @param range Range in which event will trigger if entity is within
-	 *
-	 * Proximity event is populated appropriately.
+	 * @param s What the sensor picks up, populated appropriately.
 	 */
-	void CheckForWallInProximity(class Robot* ent,
-					     EventProximity * const ep, EventEntityType * const et, double range);
+	void CheckForWallInProximity(unsigned int i, double range,
+	                             struct sensed * const s) const;
 
 	/**
 	 * @brief Update all entities for a single timestep
@@ -317,6 +545,100 @@ private:
 	 */
 	int UpdateEntitiesTimestep(void);
 
+	/**
+	 * @brief Hand where every mobile entity is at the end of the tick to the
+	 * trajectory recorder, if there is one.
+	 */
+	void RecordTrajectory(void);
+
+	/**
+	 * @brief Add an entity to the arena, in entities_, mobile_entities_ (if it
+	 * can move), the views of its type and the store.
+	 * @param ent The entity to add
+	 * @return unsigned int The slot of the entity in the store
+	 */
+	unsigned int AddEntity(class ArenaEntity * ent);
+
+	/**
+	 * @brief Put a robot or superbot in the place of the i-th robot, in
+	 * entities_, mobile_entities_ and the views. Nothing else moves, so this
+	 * takes constant time. The store is left as it is; see \ref SetInPlay().
+	 * @param i Index of the robot in robot_entities_
+	 * @param ent The robot, or the superbot it has been promoted to
+	 */
+	void PlaceRobot(unsigned int i, class Robot * ent);
+
+	/**
+	 * @brief Bring the entity in a slot of the store into play, or take it
+	 * out of play. Every pass skips the entities out of play.
+	 * @param i Slot of the entity
+	 * @param in_play Whether it is in play
+	 */
+	void SetInPlay(unsigned int i, bool in_play);
+
+	/**
+	 * @brief Refresh the store from the entities, take the promoted robots and
+	 * the superbots not promoted to yet out of play, and wake everything up.
+	 */
+	void GatherInPlay(void);
+
+	/**
+	 * @brief Update the velocity of every mobile entity, then move them all
+	 * along their headings in one batched pass over the store.
+	 * @param dt The # of timesteps to advance
+	 */
+	void MoveEntities(unsigned int dt);
+
+	/**
+	 * @brief Rebuild the broad phase grid of the awake entities from the
+	 * positions in the store, and the static grid too if it has changed.
+	 */
+	void RebuildEntityGrid(void);
+
+	/**
+	 * @brief Find the candidates for a query in both broad phase grids and
+	 * the obstacle tree.
+	 * @param t Worker running the query; its candidates are filled in, in
+	 * increasing order
+	 * @param x The x coordinate of the query point
+	 * @param y The y coordinate of the query point
+	 * @param reach Largest distance from the point to the edge of an entity
+	 * of interest
+	 * @param slack Farthest any awake entity has moved since the grid was
+	 * rebuilt (sleeping entities and obstacles don't move)
+	 */
+	void QueryEntities(unsigned int t, double x, double y, double reach,
+	                   double slack);
+
+	/**
+	 * @brief Wake the sleeping entities that an awake entity has run into
+	 * this tick, before any collisions are handled.
+	 * @return bool Whether any entity woke up
+	 */
+	bool WakeTouchedEntities(void);
+
+	/**
+	 * @brief Put robots that are frozen with nothing touching them to sleep,
+	 * wake the ones unfrozen while asleep, and update awake_ and sleeping_ to
+	 * match.
+	 */
+	void UpdateSleeping(void);
+
+	/**
+	 * @brief Recompute awake_ and sleeping_ from asleep_ and in_play_.
+	 */
+	void SortSleeping(void);
+
+	/**
+	 * @brief Split the slots [0, n) into one contiguous range per worker and
+	 * run fn on each range, in parallel.
+	 * @param n Number of slots
+	 * @param fn Called with the worker and the first and one past the last
+	 * slot of its range
+	 */
+	void ParallelFor(size_t n,
+	                 const std::function<void(unsigned int, size_t, size_t)>& fn);
+
 	/**
 	 * Under certain circumstance, the compiler requires that the copy
 	 * constructor is not defined. This is deleting the default copy const.
@@ -332,6 +654,20 @@ private:
 	unsigned int n_obstacles_; // Number of obstacles in the Arena
 	unsigned int n_robots_; // Number of robots in the Arena
 	unsigned int n_superbots_; // Number of superbots in the Arena
+	unsigned int timestep_; // # of timesteps each tick covers
+	RandomStream random_; // source of every random number in the simulation
+	uint64_t ticks_; // ticks played since the arena was built
+	class InputLog * input_log_; // where key presses and resets are recorded, if anywhere
+	class TrajectoryRecorder * trajectory_; // where trajectories are recorded, if anywhere
+
+	// Memory the entities live in, one block per type, so they sit next to
+	// each other and are freed all at once
+	EntityPool<Player> player_pool_; // holds player_
+	EntityPool<RechargeStation> recharge_station_pool_; // holds recharge_station_
+	EntityPool<HomeBase> home_base_pool_; // holds home_base_
+	EntityPool<Obstacle> obstacle_pool_; // holds the obstacles
+	EntityPool<Robot> robot_pool_; // holds robot_entities_
+	EntityPool<SuperBot> superbot_pool_; // holds superbot_entities_
 
 	// Entities populating the arena
 	Player* player_; // user controlled player
@@ -341,6 +677,57 @@ private:
 	std::vector<class ArenaMobileEntity*> mobile_entities_; // Vector containing all moving entities in the arena
 	std::vector<class Robot*> robot_entities_; // Vector containing all robots in the arena
 	std::vector<class SuperBot*> superbot_entities_; // Vector containing all superbots in the arena
+
+	// Entities in play by type. Only updated when an entity is added or a robot
+	// is promoted, so they can be handed out as spans.
+	std::vector<class Obstacle*> obstacle_view_; // obstacles and the recharge station
+	std::vector<class Robot*> robot_view_; // robots and superbots
+	std::vector<class SuperBot*> superbot_view_; // superbots
+
+	// Per-tick state of every entity: the slots of entities_ as the game
+	// started, then a slot for each superbot, in the order they are promoted.
+	// Every pass works through the slots in order, so the superbots are
+	// handled after the robots, in the order they were promoted.
+	EntityStore store_; // positions, headings, speeds and extents of the entities
+	unsigned int player_slot_; // slot of player_ in store_
+	unsigned int recharge_station_slot_; // slot of recharge_station_ in store_
+	unsigned int home_base_slot_; // slot of home_base_ in store_
+	unsigned int first_robot_slot_; // slot of robot_entities_[0] in store_ and entities_
+	unsigned int first_robot_mobile_; // index of robot_entities_[0] in mobile_entities_
+	unsigned int first_superbot_slot_; // slot of superbot_entities_[0] in store_
+	std::vector<bool> in_play_; // whether each slot's entity is in play
+
+	// Sleeping: frozen robots with nothing touching them don't move, steer or
+	// look for collisions, so only the awake entities are worked on each tick.
+	// The sleeping entities sit in a grid of their own that is only rebuilt
+	// when one of them changes, and a sleeping entity wakes up when an awake
+	// one runs into it.
+	std::vector<bool> asleep_; // whether each slot's entity is asleep
+	std::vector<unsigned int> awake_; // slots of the awake mobile entities, in order
+	std::vector<unsigned int> sleeping_; // slots of the sleeping entities, in order
+	std::vector<unsigned int> unfrozen_; // sleeping robots unfrozen in the current tick
+	bool sleeping_changed_; // whether sleeping_grid_ is out of date
+
+	// Broad phase: only entities in nearby grid cells are tested for
+	// collisions and proximity, instead of every entity in the arena. The
+	// obstacles never move, so they are put in a tree once, and kept out of
+	// the grids so their cells can be sized for the entities that move.
+	double max_radius_; // radius of the largest mobile entity in the arena
+	double max_delta_; // largest collision delta in the arena
+	double max_step_; // farthest any entity moved in the current tick, plus rounding
+	SpatialHash entity_grid_; // grid over awake_
+	SpatialHash sleeping_grid_; // grid over sleeping_
+	ObstacleTree obstacle_tree_; // tree over the obstacles and the recharge station
+
+	// Each pass runs in parallel on the workers, which only write results for
+	// their own slots; the results are then applied in slot order on the
+	// calling thread, as the single threaded loops would have. Every contact
+	// found in a tick goes in the finding worker's contact buffer, which keeps
+	// its capacity from tick to tick.
+	WorkerPool workers_; // threads each timestep is spread across
+	std::vector<worker_scratch> scratch_; // scratch space of each worker
+	std::vector<contact> contacts_; // collision pass results, slot for slot with store_
+	std::vector<sensed> sensed_; // proximity pass results, slot for slot with store_
 };
 
 NAMESPACE_END(csci3081);
@@ -0,0 +1,423 @@
+/**
+ * @file arena_bench.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/event_collision.h"
+#include "src/robot.h"
+#include "src/robot_motion_behavior.h"
+#include "src/scenario_generator.h"
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+// Most ticks played between looks at the clock
+static const unsigned int kTicksPerBatch = 64;
+
+/*******************************************************************************
+ * Allocation Counting
+ ******************************************************************************/
+// Calls to operator new since the program started, from every thread
+static std::atomic<unsigned long> g_allocations(0);
+
+void * operator new(size_t size) {
+	++g_allocations;
+	void * p = malloc(size ? size : 1);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void * operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void * p) noexcept {
+	free(p);
+}
+
+void operator delete[](void * p) noexcept {
+	free(p);
+}
+
+void operator delete(void * p, __unused size_t size) noexcept {
+	free(p);
+}
+
+void operator delete[](void * p, __unused size_t size) noexcept {
+	free(p);
+}
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Runs the arena's private collision, proximity and bounds checks on
+ * their own, over every robot, as they are run on the arena's state at the
+ * end of its last tick.
+ */
+class ArenaBench {
+public:
+	/**
+	 * @brief Get the number of entities in an arena, of every type.
+	 */
+	static size_t n_entities(const Arena& arena) {
+		return arena.store_.size();
+	}
+
+	/**
+	 * @brief Check each robot for a collision with the robot in the next slot,
+	 * which is usually its neighbor in a generated arena.
+	 * @return unsigned long Number of checks made
+	 */
+	static unsigned long CollisionPass(Arena * const arena) {
+		EventCollision ec;
+		unsigned int n = arena->n_robots_;
+		unsigned int first = arena->first_robot_slot_;
+		for (unsigned int k = 0; k < n; ++k) {
+			arena->CheckForEntityCollision(first + k, first + (k + 1) % n, &ec);
+		}
+		return n;
+	}
+
+	/**
+	 * @brief Check each robot for the robot in the next slot in range of its
+	 * proximity sensor.
+	 * @return unsigned long Number of checks made
+	 */
+	static unsigned long ProximityPass(Arena * const arena) {
+		Arena::sensed s;
+		unsigned int n = arena->n_robots_;
+		unsigned int first = arena->first_robot_slot_;
+		double range = arena->robot_entities_[0]->get_proximity_range();
+		for (unsigned int k = 0; k < n; ++k) {
+			arena->CheckForEntityInProximity(first + k, first + (k + 1) % n, range,
+			                                 &s);
+		}
+		return n;
+	}
+
+	/**
+	 * @brief Check each robot for having gone out of the arena.
+	 * @return unsigned long Number of checks made
+	 */
+	static unsigned long OutOfBoundsPass(Arena * const arena) {
+		Arena::contact c;
+		Arena::contact_record rec;
+		unsigned int n = arena->n_robots_;
+		unsigned int first = arena->first_robot_slot_;
+		for (unsigned int k = 0; k < n; ++k) {
+			arena->CheckForEntityOutOfBounds(first + k, &c, &rec);
+		}
+		return n;
+	}
+};
+
+NAMESPACE_END(csci3081);
+
+/**
+ * @brief Times the parts of a benchmark that count, and the allocations made
+ * during them.
+ */
+class Stopwatch {
+public:
+	Stopwatch(void) : seconds_(0), allocations_(0), start_(),
+		start_allocations_(0) {
+	}
+
+	/**
+	 * @brief Start timing.
+	 */
+	void Start(void) {
+		start_allocations_ = g_allocations;
+		start_ = std::chrono::steady_clock::now();
+	}
+
+	/**
+	 * @brief Stop timing, adding the time and allocations since Start().
+	 */
+	void Stop(void) {
+		seconds_ += std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start_).count();
+		allocations_ += g_allocations - start_allocations_;
+	}
+
+	/**
+	 * @brief Get the time timed so far, in seconds.
+	 */
+	double seconds(void) const {
+		return seconds_;
+	}
+
+	/**
+	 * @brief Get the allocations made while timing so far.
+	 */
+	unsigned long allocations(void) const {
+		return allocations_;
+	}
+
+private:
+	double seconds_; // time timed so far
+	unsigned long allocations_; // allocations made while timing so far
+	std::chrono::steady_clock::time_point start_; // when Start() was last called
+	unsigned long start_allocations_; // g_allocations when Start() was last called
+};
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief How one benchmark went at one entity count.
+ */
+struct bench_result {
+	bench_result(void) : name(), robots(0), entities(0), ops(0), seconds(0),
+		allocations(0) {
+	}
+
+	std::string name; // what was timed
+	unsigned long robots; // robots in the arena
+	size_t entities; // entities in the arena, of every type
+	unsigned long ops; // times it was done
+	double seconds; // time it took, all told
+	unsigned long allocations; // allocations it made, all told
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Print the command line usage of the arena benchmarks.
+ * @param prog Name the program was invoked with
+ */
+static void PrintUsage(const char * prog) {
+	fprintf(stderr,
+	        "Usage: %s [-n counts] [-m seconds] [-j threads] [-o file]\n"
+	        "  -n counts   Comma separated robot counts to run at (default 10,100,1000,10000,100000)\n"
+	        "  -m seconds  Least time to spend timing each benchmark (default 0.2)\n"
+	        "  -j threads  Spread each tick across this many threads (default 1)\n"
+	        "  -o file     Write the results as JSON to this file (default: standard output)\n",
+	        prog);
+}
+
+/**
+ * @brief Run a benchmark over and over until it has been timed for long
+ * enough.
+ * @param pass Runs the benchmark once or more, timing what counts with the
+ * stopwatch it is given, and returns how many times it ran it
+ */
+template <class Pass>
+static struct bench_result Run(const char * name, unsigned long robots,
+                               size_t entities, double min_seconds,
+                               Pass pass) {
+	Stopwatch watch;
+	struct bench_result result;
+	result.name = name;
+	result.robots = robots;
+	result.entities = entities;
+	do {
+		result.ops += pass(&watch);
+	} while (watch.seconds() < min_seconds);
+	result.seconds = watch.seconds();
+	result.allocations = watch.allocations();
+	fprintf(stderr, "%-16s %7lu robots  %14.1f ns/op  %10.2f allocs/op\n",
+	        name, robots, result.seconds * 1e9 / result.ops,
+	        static_cast<double>(result.allocations) / result.ops);
+	return result;
+}
+
+/**
+ * @brief Time a pass over every robot, ops at a time.
+ */
+template <class Op>
+static struct bench_result RunPass(const char * name, unsigned long robots,
+                                   size_t entities, double min_seconds, Op op) {
+	return Run(name, robots, entities, min_seconds,
+	           [&op](Stopwatch * watch) {
+		watch->Start();
+		unsigned long ops = op();
+		watch->Stop();
+		return ops;
+	});
+}
+
+/**
+ * @brief Write the results as JSON.
+ */
+static void WriteJson(FILE * f, const std::vector<struct bench_result>& results,
+                      unsigned int n_threads, double min_seconds) {
+	fprintf(f, "{\n  \"benchmark\": \"arena_bench\",\n  \"threads\": %u,\n"
+	        "  \"min_seconds\": %g,\n  \"results\": [\n", n_threads, min_seconds);
+	for (size_t i = 0; i < results.size(); ++i) {
+		const struct bench_result& r = results[i];
+		double ns_per_op = r.seconds * 1e9 / r.ops;
+		double allocs_per_op = static_cast<double>(r.allocations) / r.ops;
+		fprintf(f, "    {\"name\": \"%s\", \"robots\": %lu, \"entities\": %zu, "
+		        "\"ops\": %lu, \"seconds\": %.6f, \"ns_per_op\": %.1f, "
+		        "\"ops_per_sec\": %.1f, \"allocs_per_op\": %.3f",
+		        r.name.c_str(), r.robots, r.entities, r.ops, r.seconds, ns_per_op,
+		        r.ops / r.seconds, allocs_per_op);
+		if (r.name == "advance_time") {
+			fprintf(f, ", \"ticks_per_sec\": %.1f, \"allocs_per_tick\": %.3f",
+			        r.ops / r.seconds, allocs_per_op);
+		}
+		fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+	}
+	fprintf(f, "  ]\n}\n");
+}
+
+/**
+ * @brief Time the hot parts of the simulation in generated arenas of several
+ * sizes (see GenerateScenario()), each with a tenth as many obstacles as
+ * robots, and write how long each took and how many allocations it made as
+ * JSON:
+ *
+ * - construct: building the arena, with all of its entities
+ * - advance_time: Arena::AdvanceTime(), restarting each game it finishes
+ * - reset: Arena::Reset()
+ * - collision, proximity, out_of_bounds: Arena::CheckForEntityCollision(),
+ *   CheckForEntityInProximity() and CheckForEntityOutOfBounds(), once per
+ *   robot
+ * - update_position: RobotMotionBehavior::UpdatePosition(), once per robot
+ */
+int main(int argc, char **argv) {
+	std::vector<unsigned long> counts = {10, 100, 1000, 10000, 100000};
+	double min_seconds = 0.2;
+	unsigned int n_threads = 1;
+	const char * out_path = NULL;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:m:j:o:h")) != -1) {
+		switch (opt) {
+		case 'n': {
+			counts.clear();
+			char * at = optarg;
+			while (*at) {
+				counts.push_back(strtoul(at, &at, 10));
+				if (*at == ',') {
+					++at;
+				}
+				else if (*at) {
+					PrintUsage(argv[0]);
+					return 1;
+				}
+			}
+			break;
+		}
+		case 'm':
+			min_seconds = strtod(optarg, NULL);
+			break;
+		case 'j':
+			n_threads = strtoul(optarg, NULL, 10);
+			break;
+		case 'o':
+			out_path = optarg;
+			break;
+		default:
+			PrintUsage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	std::vector<struct bench_result> results;
+	for (auto n : counts) {
+		csci3081::generator_params gparams;
+		gparams.n_robots = n;
+		gparams.n_obstacles = n / 10;
+		csci3081::arena_params aparams;
+		if (n == 0 || !csci3081::GenerateScenario(gparams, &aparams)) {
+			fprintf(stderr, "Could not generate an arena with %lu robots\n", n);
+			return 1;
+		}
+		csci3081::Arena arena(&aparams);
+		arena.set_threads(n_threads);
+		size_t entities = csci3081::ArenaBench::n_entities(arena);
+
+		results.push_back(Run("construct", n, entities, min_seconds,
+		                      [&aparams](Stopwatch * watch) {
+			watch->Start();
+			std::unique_ptr<csci3081::Arena> built(new csci3081::Arena(&aparams));
+			watch->Stop();
+			return 1ul;
+		}));
+
+		results.push_back(Run("advance_time", n, entities, min_seconds,
+		                      [&arena](Stopwatch * watch) {
+			unsigned long ticks = 0;
+			int game_status = 2;
+			watch->Start();
+			while (game_status == 2 && ticks < kTicksPerBatch) {
+				game_status = arena.AdvanceTime();
+				++ticks;
+			}
+			watch->Stop();
+			if (game_status != 2) {
+				arena.Reset();
+			}
+			return ticks;
+		}));
+
+		results.push_back(RunPass("reset", n, entities, min_seconds,
+		                          [&arena](void) {
+			arena.Reset();
+			return 1ul;
+		}));
+
+		// The checks run on where the entities are after a tick of moving
+		arena.AdvanceTime();
+		results.push_back(RunPass("collision", n, entities, min_seconds,
+		                          [&arena](void) {
+			return csci3081::ArenaBench::CollisionPass(&arena);
+		}));
+		results.push_back(RunPass("proximity", n, entities, min_seconds,
+		                          [&arena](void) {
+			return csci3081::ArenaBench::ProximityPass(&arena);
+		}));
+		results.push_back(RunPass("out_of_bounds", n, entities, min_seconds,
+		                          [&arena](void) {
+			return csci3081::ArenaBench::OutOfBoundsPass(&arena);
+		}));
+
+		csci3081::RobotMotionBehavior behavior;
+		results.push_back(RunPass("update_position", n, entities, min_seconds,
+		                          [&arena, &behavior](void) {
+			for (auto r : arena.robots()) {
+				behavior.UpdatePosition(r, 1);
+			}
+			return static_cast<unsigned long>(arena.robots().size());
+		}));
+	}
+
+	FILE * f = out_path ? fopen(out_path, "w") : stdout;
+	if (!f) {
+		fprintf(stderr, "Could not open %s\n", out_path);
+		return 1;
+	}
+	WriteJson(f, results, n_threads, min_seconds);
+	if (out_path && fclose(f) != 0) {
+		fprintf(stderr, "Could not write %s\n", out_path);
+		return 1;
+	}
+	return 0;
+}
@@ -10,11 +10,13 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <nanogui/nanogui.h>
 #include <string>
+#include <sys/types.h>
 #include "src/common.h"
 #include "src/position.h"
 #include "src/color.h"
+#include "src/entity_type.h"
+#include "src/state_stream.h"
 
 /*******************************************************************************
  * Namespaces
@@ -49,7 +51,7 @@ public:
 	 * @param color Holds color of entity in arena in RGBA
 	 */
 	ArenaEntity(double radius, const Position& pos, const csci3081::Color& color) :
-		radius_(radius), pos_(pos), color_(color) {
+		radius_(radius), pos_(pos), color_(color), type_(kNone), id_(-1) {
 	}
 
 	/**
@@ -73,6 +75,25 @@ public:
 	virtual void Reset(void) {
 	}
 
+	/**
+	 * @brief Write everything about the entity that changes as the game is
+	 * played, for \ref Arena::Snapshot(). What it was built with (radius,
+	 * color, ...) is left out.
+	 * @param out Where to write it
+	 */
+	virtual void SaveState(StateWriter * const out) const {
+		out->Write(pos_);
+	}
+
+	/**
+	 * @brief Read back the state written by \ref SaveState(), for
+	 * \ref Arena::Restore().
+	 * @param in Where to read it from
+	 */
+	virtual void LoadState(StateReader * const in) {
+		in->Read(&pos_);
+	}
+
 	/**
 	 * @brief Get the name of an entity for visualization purposes, to aid in
 	 * debugging.
@@ -116,10 +137,47 @@ public:
 		return radius_;
 	}
 
+	/**
+	 * @brief Gets what kind of entity this is. Unlike \ref get_name(), this
+	 * is cheap enough to check in the simulation's inner loops.
+	 */
+	enum entity_type get_type(void) const {
+		return type_;
+	}
+
+	/**
+	 * @brief Gets the id of the ArenaEntity, which numbers the entities of a
+	 * kind within the arena they are in (-1 until the arena assigns it).
+	 */
+	int get_id(void) const {
+		return id_;
+	}
+
+	/**
+	 * @brief Sets the id of the ArenaEntity. Ids are handed out by the arena
+	 * that owns the entity, so arenas can be built on any thread.
+	 * @param id New id of the ArenaEntity
+	 */
+	void set_id(int id) {
+		id_ = id;
+	}
+
+protected:
+	/**
+	 * @brief Sets what kind of entity this is. Each concrete entity class does
+	 * this in its constructor.
+	 * @param type The type of the entity
+	 */
+	void set_type(enum entity_type type) {
+		type_ = type;
+	}
+
 private:
 	double radius_; // radius of entity in pixels
 	Position pos_; // holds x and y coordinates of the entity in the arena
 	csci3081::Color color_;  // holds color of entity in arena in RGBA
+	enum entity_type type_; // what kind of entity this is
+	int id_; // number of the entity among its kind in the arena
 };
 
 NAMESPACE_END(csci3081);
@@ -10,7 +10,7 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <nanogui/nanogui.h>
+#include <sys/types.h>
 #include "src/common.h"
 #include "src/position.h"
 #include "src/color.h"
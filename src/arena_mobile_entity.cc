@@ -26,8 +26,11 @@ NAMESPACE_BEGIN(csci3081);
  *   position/velocity were updated.
  */
 void ArenaMobileEntity::TimestepUpdate(uint dt) {
+	Position old_pos = get_pos();
+	UpdateVelocity();
 	RobotMotionBehavior h;
 	h.UpdatePosition(this, dt);
+	PositionUpdated(old_pos, dt);
 }
 
 NAMESPACE_END(csci3081);
@@ -93,6 +93,26 @@ public:
 	 */
 	void TimestepUpdate(uint dt) override;
 
+	/**
+	 * @brief Update the entity's heading and speed from what its sensors
+	 * picked up during the last timestep. This is the first half of
+	 * \ref TimestepUpdate(); the arena calls it directly when it moves all
+	 * entities at once (see IntegratePositions()).
+	 */
+	virtual void UpdateVelocity(void) {
+	}
+
+	/**
+	 * @brief Let the entity react to having moved. This is the second half of
+	 * \ref TimestepUpdate().
+	 *
+	 * @param old_pos Position of the entity before it moved
+	 * @param dt The # of timesteps the entity moved for
+	 */
+	virtual void PositionUpdated(__unused const Position& old_pos,
+	                             __unused uint dt) {
+	}
+
 	/**
 	 * @brief Get the minimum distance between two arena entities that will be
 	 * considered a collision.
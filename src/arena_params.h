@@ -11,6 +11,8 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <stdint.h>
+#include <vector>
 #include "src/robot_params.h"
 #include "src/player_params.h"
 #include "src/home_base_params.h"
@@ -21,11 +23,6 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
-/*******************************************************************************
- * Constant Definitions
- ******************************************************************************/
-#define MAX_OBSTACLES 8
-#define MAX_ROBOTS 8
 /*******************************************************************************
  * Structure Definitions
  ******************************************************************************/
@@ -33,7 +30,8 @@ NAMESPACE_BEGIN(csci3081);
  * @brief Define the parameter for the arena.
  *
  * This includes the arena geometry as well as the parameters for \c ALL
- * entities within the arena.
+ * entities within the arena. There can be any number of obstacles and robots;
+ * reserve() the vectors before filling them when building large scenes.
  */
 struct arena_params {
 	// player() : player_params(arena_mobile_entity_params(arena_entity_params(radius(), pos(), color()), collision_delta()), battery_max_charge(), angle_delta())
@@ -43,20 +41,19 @@ struct arena_params {
 	// robots() : robot_params(arena_mobile_entity_params(arena_mobile_entity_params(arena_entity_params(radius(), pos(), color()), collision_delta())), angle_delta(), starting_pos())
 	// superbots() : superbot_params(robot_params(arena_mobile_entity_params(arena_mobile_entity_params(arena_entity_params(radius(), pos(), color()), collision_delta())), angle_delta(), starting_pos()), angle_delta(), starting_pos())
 	arena_params(void) : player(), recharge_station(), home_base(), obstacles(),
-		robots(), superbots(), n_superbots(), n_obstacles(), n_robots(), x_dim(), y_dim() {
+		robots(), superbots(), x_dim(), y_dim(), seed(), timestep(1) {
 	}
 
 	struct player_params player; // parameters for the player entity
 	struct arena_entity_params recharge_station; // parameters for the recharge station arena entity
 	struct home_base_params home_base; // parameters for the home base arena entity
-	struct arena_entity_params obstacles[MAX_OBSTACLES]; // parameters for the obstacle arena entities
-	struct robot_params robots[MAX_ROBOTS]; // parameters for the robots
-	struct superbot_params superbots[MAX_ROBOTS]; // parameters for the superbots
-	size_t n_superbots; // number of SuperBots in the arena
-	size_t n_obstacles; // number of Obstacles in the arena
-	size_t n_robots; // number of Robots in the arena
+	std::vector<struct arena_entity_params> obstacles; // parameters for the obstacle arena entities
+	std::vector<struct robot_params> robots; // parameters for the robots
+	std::vector<struct superbot_params> superbots; // parameters for the superbot each robot is promoted to (one per robot)
 	uint x_dim; // number of pixels wide the arena is
 	uint y_dim; // number of pixels tall the arena is
+	uint64_t seed; // seed of the arena's random numbers; equal seeds replay equal games
+	uint timestep; // # of timesteps each tick of the arena covers (see Arena::AdvanceTime())
 };
 
 NAMESPACE_END(csci3081);
@@ -0,0 +1,203 @@
+/**
+ * @file arena_params_stream.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/arena_params_stream.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Append the parameters every entity has.
+ */
+static void SaveEntityParams(const struct arena_entity_params& params,
+                             StateWriter * const w) {
+	w->Write(params.radius);
+	w->Write(params.pos);
+	w->Write(static_cast<int32_t>(params.color.r));
+	w->Write(static_cast<int32_t>(params.color.g));
+	w->Write(static_cast<int32_t>(params.color.b));
+	w->Write(static_cast<int32_t>(params.color.a));
+}
+
+/**
+ * @brief Read back the parameters every entity has.
+ */
+static void LoadEntityParams(StateReader * const r,
+                             struct arena_entity_params * const params) {
+	int32_t red = 0, green = 0, blue = 0, alpha = 0;
+	r->Read(&params->radius);
+	r->Read(&params->pos);
+	r->Read(&red);
+	r->Read(&green);
+	r->Read(&blue);
+	r->Read(&alpha);
+	params->color = Color(red, green, blue, alpha);
+}
+
+/**
+ * @brief Append the parameters of a player (or home base).
+ */
+static void SavePlayerParams(const struct player_params& params,
+                             StateWriter * const w) {
+	SaveEntityParams(params, w);
+	w->Write(params.collision_delta);
+	w->Write(params.battery_max_charge);
+	w->Write(static_cast<uint32_t>(params.angle_delta));
+}
+
+/**
+ * @brief Read back the parameters of a player (or home base).
+ */
+static void LoadPlayerParams(StateReader * const r,
+                             struct player_params * const params) {
+	uint32_t angle_delta = 0;
+	LoadEntityParams(r, params);
+	r->Read(&params->collision_delta);
+	r->Read(&params->battery_max_charge);
+	r->Read(&angle_delta);
+	params->angle_delta = angle_delta;
+}
+
+/**
+ * @brief Append the parameters of a robot.
+ */
+static void SaveRobotParams(const struct robot_params& params,
+                            StateWriter * const w) {
+	SaveEntityParams(params, w);
+	w->Write(params.collision_delta);
+	w->Write(static_cast<uint32_t>(params.angle_delta));
+	w->Write(params.starting_pos);
+}
+
+/**
+ * @brief Read back the parameters of a robot.
+ */
+static void LoadRobotParams(StateReader * const r,
+                            struct robot_params * const params) {
+	uint32_t angle_delta = 0;
+	LoadEntityParams(r, params);
+	r->Read(&params->collision_delta);
+	r->Read(&angle_delta);
+	r->Read(&params->starting_pos);
+	params->angle_delta = angle_delta;
+}
+
+/**
+ * @brief Append the parameters of a superbot: those of the robot it is built
+ * from, then its own.
+ */
+static void SaveSuperBotParams(const struct superbot_params& params,
+                               StateWriter * const w) {
+	SaveRobotParams(params, w);
+	w->Write(static_cast<uint32_t>(params.superbot_params::angle_delta));
+	w->Write(params.superbot_params::starting_pos);
+}
+
+/**
+ * @brief Read back the parameters of a superbot.
+ */
+static void LoadSuperBotParams(StateReader * const r,
+                               struct superbot_params * const params) {
+	uint32_t angle_delta = 0;
+	LoadRobotParams(r, params);
+	r->Read(&angle_delta);
+	r->Read(&params->superbot_params::starting_pos);
+	params->superbot_params::angle_delta = angle_delta;
+}
+
+/**
+ * @brief Read the length of a list of entities, checking that there are
+ * enough bytes left for that many, so a damaged length can't ask for more
+ * memory than the whole file could describe.
+ */
+static bool LoadCount(StateReader * const r, size_t min_entity_size,
+                      uint32_t * const count) {
+	return r->Read(count) && *count <= r->remaining() / min_entity_size;
+}
+
+/**
+ * @brief Append everything an arena is built from.
+ * @param params Arena parameters to save
+ * @param w Where to append them
+ */
+void SaveArenaParams(const struct arena_params& params, StateWriter * const w) {
+	w->Write(static_cast<uint32_t>(params.x_dim));
+	w->Write(static_cast<uint32_t>(params.y_dim));
+	w->Write(params.seed);
+	w->Write(static_cast<uint32_t>(params.timestep));
+	SavePlayerParams(params.player, w);
+	SaveEntityParams(params.recharge_station, w);
+	SavePlayerParams(params.home_base, w);
+	w->Write(static_cast<uint32_t>(params.obstacles.size()));
+	for (const auto& o : params.obstacles) {
+		SaveEntityParams(o, w);
+	}
+	w->Write(static_cast<uint32_t>(params.robots.size()));
+	for (const auto& rb : params.robots) {
+		SaveRobotParams(rb, w);
+	}
+	w->Write(static_cast<uint32_t>(params.superbots.size()));
+	for (const auto& s : params.superbots) {
+		SaveSuperBotParams(s, w);
+	}
+}
+
+/**
+ * @brief Read back arena parameters that SaveArenaParams() wrote.
+ * @param r Where to read them from
+ * @param params Set to the parameters read
+ * @return bool Whether a whole, usable set of parameters was read
+ */
+bool LoadArenaParams(StateReader * const r, struct arena_params * const params) {
+	// Smallest an entity of any kind can be saved in: radius, position, color
+	const size_t kMinEntitySize = sizeof(double) + 6 * sizeof(int32_t);
+	uint32_t x_dim = 0, y_dim = 0, timestep = 0, count = 0;
+	r->Read(&x_dim);
+	r->Read(&y_dim);
+	r->Read(&params->seed);
+	r->Read(&timestep);
+	params->x_dim = x_dim;
+	params->y_dim = y_dim;
+	params->timestep = timestep;
+	LoadPlayerParams(r, &params->player);
+	LoadEntityParams(r, &params->recharge_station);
+	LoadPlayerParams(r, &params->home_base);
+
+	if (!LoadCount(r, kMinEntitySize, &count)) {
+		return false;
+	}
+	params->obstacles.assign(count, arena_entity_params());
+	for (auto& o : params->obstacles) {
+		LoadEntityParams(r, &o);
+	}
+	if (!LoadCount(r, kMinEntitySize, &count)) {
+		return false;
+	}
+	params->robots.assign(count, robot_params());
+	for (auto& rb : params->robots) {
+		LoadRobotParams(r, &rb);
+	}
+	if (!LoadCount(r, kMinEntitySize, &count)) {
+		return false;
+	}
+	params->superbots.assign(count, superbot_params());
+	for (auto& s : params->superbots) {
+		LoadSuperBotParams(r, &s);
+	}
+
+	// Every robot needs a superbot to be promoted to
+	return !r->failed() && params->superbots.size() >= params->robots.size();
+}
+
+NAMESPACE_END(csci3081);
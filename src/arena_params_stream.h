@@ -0,0 +1,44 @@
+/**
+ * @file arena_params_stream.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ARENA_PARAMS_STREAM_H_
+#define SRC_ARENA_PARAMS_STREAM_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/arena_params.h"
+#include "src/state_stream.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Append everything an arena is built from: the size, seed and
+ * timestep of the arena and the parameters of every entity, with each list of
+ * entities preceded by its length.
+ * @param params Arena parameters to save
+ * @param w Where to append them
+ */
+void SaveArenaParams(const struct arena_params& params, StateWriter * const w);
+
+/**
+ * @brief Read back arena parameters that \ref SaveArenaParams() wrote.
+ * @param r Where to read them from
+ * @param params Set to the parameters read
+ * @return bool Whether a whole, usable set of parameters was read; it isn't
+ * if the bytes run out or a list is longer than the bytes left could hold
+ */
+bool LoadArenaParams(StateReader * const r, struct arena_params * const params);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ARENA_PARAMS_STREAM_H_
@@ -0,0 +1,373 @@
+/**
+ * @file arenasim.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <unistd.h>
+#include <cstdio>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+#include "src/arena_params.h"
+#include "src/arena.h"
+#include "src/default_arena_params.h"
+#include "src/ensemble.h"
+#include "src/input_log.h"
+#include "src/scenario.h"
+#include "src/trajectory_reader.h"
+#include "src/trajectory_recorder.h"
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Print the command line usage of the headless simulation runner.
+ * @param prog Name the program was invoked with
+ */
+static void PrintUsage(const char * prog) {
+	fprintf(stderr,
+	        "Usage: %s [-f scenario] [-g games] [-t max_ticks] [-s seed] [-d steps] [-p games] [-j threads] [-H bucket] [-q] [-w log | -r log | -T trace | -R trace [-e robot] | -o file | -b file]\n"
+	        "  -f scenario   Play the arena in a scenario file (default: the built-in one)\n"
+	        "  -g games      Number of games to play (default 1)\n"
+	        "  -t max_ticks  Give up on a game after this many ticks (default 1000000)\n"
+	        "  -s seed       Seed of the first game; later games continue its stream (default: the scenario's)\n"
+	        "  -d steps      Timesteps each tick covers; fewer, longer ticks per game (default: the scenario's)\n"
+	        "  -p games      Play this many games at once, one per thread (default 1)\n"
+	        "  -j threads    Spread each tick of a game across this many threads (default 1)\n"
+	        "  -H bucket     Print histograms of ticks to completion, bucket ticks wide\n"
+	        "  -q            Only print the summary, not every game\n"
+	        "  -w log        Play one game and record it to the log file\n"
+	        "  -r log        Replay a recorded game and check it ends the same way\n"
+	        "  -T trace      Play one game and record the trajectory of every mobile entity to the trace file\n"
+	        "  -R trace      Print what a trace file holds\n"
+	        "  -e robot      With -R, print the trajectory of the robot with this id\n"
+	        "  -o file       Write the scenario as text and exit\n"
+	        "  -b file       Write the scenario in binary, to be loaded quickly, and exit\n",
+	        prog);
+}
+
+/**
+ * @brief Print a ticks-to-completion histogram, one line per non-empty bucket.
+ */
+static void PrintHistogram(const char * outcome,
+                           const std::vector<unsigned long>& histogram,
+                           unsigned long bucket_ticks) {
+	for (size_t b = 0; b < histogram.size(); ++b) {
+		if (histogram[b] > 0) {
+			printf("%s ticks %lu-%lu: %lu\n", outcome, b * bucket_ticks,
+			       (b + 1) * bucket_ticks - 1, histogram[b]);
+		}
+	}
+}
+
+/**
+ * @brief Replay a recorded game as fast as the CPU allows and report whether
+ * it ended in the state it was recorded in.
+ * @return int Exit status: 0 if it did, 1 if not
+ */
+static int Replay(const char * path, unsigned int n_threads) {
+	csci3081::InputLog log;
+	if (!log.Load(path)) {
+		fprintf(stderr, "Could not read an input log from %s\n", path);
+		return 1;
+	}
+	csci3081::replay_result result = csci3081::ReplayInputLog(log, n_threads);
+	printf("inputs: %zu  ticks: %llu  seconds: %.6f  ticks/sec: %.0f\n",
+	       log.events().size(), static_cast<unsigned long long>(result.ticks),
+	       result.seconds,
+	       result.seconds > 0 ? result.ticks / result.seconds : 0.0);
+	printf("state hash: %016llx  recorded: %016llx  %s\n",
+	       static_cast<unsigned long long>(result.state_hash),
+	       static_cast<unsigned long long>(log.state_hash()),
+	       result.matched ? "match" : "MISMATCH");
+	return result.matched ? 0 : 1;
+}
+
+/**
+ * @brief Play one game without any graphics (or key presses) and record it,
+ * to be replayed later.
+ * @return int Exit status: 0 if the log was written, 1 if not
+ */
+static int Record(const char * path,
+                  const csci3081::arena_params& aparams,
+                  const csci3081::ensemble_params& eparams) {
+	csci3081::InputLog log;
+	csci3081::Arena arena(&aparams);
+	arena.set_threads(eparams.arena_threads);
+	log.Start(aparams);
+	arena.set_input_log(&log);
+	int game_status = 2;
+	while (game_status == 2 && arena.ticks() < eparams.max_ticks) {
+		game_status = arena.AdvanceTime();
+	}
+	log.Finish(arena);
+	if (!log.Save(path)) {
+		fprintf(stderr, "Could not write the input log to %s\n", path);
+		return 1;
+	}
+	printf("recorded %llu ticks to %s, state hash %016llx\n",
+	       static_cast<unsigned long long>(log.ticks()), path,
+	       static_cast<unsigned long long>(log.state_hash()));
+	return 0;
+}
+
+/**
+ * @brief Play one game without any graphics (or key presses) and record where
+ * every mobile entity is at the end of each tick.
+ * @return int Exit status: 0 if the trace was written, 1 if not
+ */
+static int Trace(const char * path,
+                 const csci3081::arena_params& aparams,
+                 const csci3081::ensemble_params& eparams) {
+	csci3081::TrajectoryRecorder recorder;
+	csci3081::Arena arena(&aparams);
+	arena.set_threads(eparams.arena_threads);
+	if (!recorder.Open(path, arena.trajectory_entities())) {
+		fprintf(stderr, "Could not open the trace file %s\n", path);
+		return 1;
+	}
+	arena.set_trajectory_recorder(&recorder);
+	auto start = std::chrono::steady_clock::now();
+	int game_status = 2;
+	while (game_status == 2 && arena.ticks() < eparams.max_ticks) {
+		game_status = arena.AdvanceTime();
+	}
+	bool written = recorder.Close();
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+	if (!written) {
+		fprintf(stderr, "Could not write the trace to %s\n", path);
+		return 1;
+	}
+	printf("traced %llu ticks of %zu entities to %s: %llu bytes, %.2f bytes/entity/tick\n",
+	       static_cast<unsigned long long>(recorder.ticks_written()),
+	       arena.trajectory_entities().size(), path,
+	       static_cast<unsigned long long>(recorder.bytes_written()),
+	       recorder.ticks_written() > 0 ?
+	       static_cast<double>(recorder.bytes_written()) /
+	       recorder.ticks_written() / arena.trajectory_entities().size() : 0.0);
+	printf("seconds: %.6f  ticks/sec: %.0f\n", seconds,
+	       seconds > 0 ? arena.ticks() / seconds : 0.0);
+	return 0;
+}
+
+/**
+ * @brief Print what a trace file holds, or the trajectory of one robot in it.
+ * @param robot Id of the robot to print, or -1 for a summary of the file
+ * @return int Exit status: 0 if the trace could be read, 1 if not
+ */
+static int ReadTrace(const char * path, long robot) {
+	csci3081::TrajectoryReader reader;
+	if (!reader.Open(path)) {
+		fprintf(stderr, "Could not read a trace from %s\n", path);
+		return 1;
+	}
+	if (reader.n_chunks() == 0) {
+		printf("%zu entities, no ticks\n", reader.n_entities());
+		return 0;
+	}
+	uint64_t first = reader.chunk(0).first_tick;
+	const csci3081::trajectory_chunk& last = reader.chunk(reader.n_chunks() - 1);
+	uint64_t end = last.first_tick + last.n_ticks;
+
+	if (robot < 0) {
+		uint64_t bytes[csci3081::kNumColumns] = {0};
+		for (size_t i = 0; i < reader.n_chunks(); ++i) {
+			for (int c = 0; c < csci3081::kNumColumns; ++c) {
+				bytes[c] += reader.chunk(i).columns[c].size;
+			}
+		}
+		printf("%zu entities, ticks %llu-%llu in %zu chunks\n",
+		       reader.n_entities(), static_cast<unsigned long long>(first),
+		       static_cast<unsigned long long>(end - 1), reader.n_chunks());
+		printf("bytes: x %llu  y %llu  heading %llu  speed %llu  flags %llu\n",
+		       static_cast<unsigned long long>(bytes[csci3081::kColumnX]),
+		       static_cast<unsigned long long>(bytes[csci3081::kColumnY]),
+		       static_cast<unsigned long long>(bytes[csci3081::kColumnHeading]),
+		       static_cast<unsigned long long>(bytes[csci3081::kColumnSpeed]),
+		       static_cast<unsigned long long>(bytes[csci3081::kColumnFlags]));
+		return 0;
+	}
+
+	size_t entity;
+	if (!reader.FindEntity(csci3081::kRobot, robot, &entity)) {
+		fprintf(stderr, "No robot %ld in %s\n", robot, path);
+		return 1;
+	}
+	std::vector<double> columns[csci3081::kNumColumns];
+	for (int c = 0; c < csci3081::kNumColumns; ++c) {
+		if (!reader.ReadEntity(entity, static_cast<csci3081::trajectory_column>(c),
+		                       first, end, &columns[c])) {
+			fprintf(stderr, "Could not read robot %ld from %s\n", robot, path);
+			return 1;
+		}
+	}
+	printf("tick x y heading speed flags\n");
+	for (size_t t = 0; t < end - first; ++t) {
+		printf("%llu %.0f %.0f %.17g %.17g %.0f\n",
+		       static_cast<unsigned long long>(first + t),
+		       columns[csci3081::kColumnX][t], columns[csci3081::kColumnY][t],
+		       columns[csci3081::kColumnHeading][t],
+		       columns[csci3081::kColumnSpeed][t],
+		       columns[csci3081::kColumnFlags][t]);
+	}
+	return 0;
+}
+
+/**
+ * @brief Run the simulation without any graphics, stepping the arenas as fast
+ * as the CPU allows, and report the outcome of each game and the overall
+ * throughput in ticks per second.
+ */
+int main(int argc, char **argv) {
+	unsigned long n_games = 1;
+	csci3081::ensemble_params eparams;
+	bool seeded = false;
+	uint64_t seed = 0;
+	unsigned int timestep = 0;
+	bool histogram = false;
+	bool quiet = false;
+	const char * record_path = NULL;
+	const char * replay_path = NULL;
+	const char * trace_path = NULL;
+	const char * read_trace_path = NULL;
+	long trace_robot = -1;
+	const char * scenario_path = NULL;
+	const char * text_path = NULL;
+	const char * binary_path = NULL;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "f:g:t:s:d:p:j:H:qw:r:T:R:e:o:b:h")) != -1) {
+		switch (opt) {
+		case 'f':
+			scenario_path = optarg;
+			break;
+		case 'g':
+			n_games = strtoul(optarg, NULL, 10);
+			break;
+		case 't':
+			eparams.max_ticks = strtoul(optarg, NULL, 10);
+			break;
+		case 's':
+			seed = strtoull(optarg, NULL, 10);
+			seeded = true;
+			break;
+		case 'd':
+			timestep = strtoul(optarg, NULL, 10);
+			break;
+		case 'p':
+			eparams.n_threads = strtoul(optarg, NULL, 10);
+			break;
+		case 'j':
+			eparams.arena_threads = strtoul(optarg, NULL, 10);
+			break;
+		case 'H':
+			eparams.bucket_ticks = strtoul(optarg, NULL, 10);
+			histogram = true;
+			break;
+		case 'q':
+			quiet = true;
+			break;
+		case 'w':
+			record_path = optarg;
+			break;
+		case 'r':
+			replay_path = optarg;
+			break;
+		case 'T':
+			trace_path = optarg;
+			break;
+		case 'R':
+			read_trace_path = optarg;
+			break;
+		case 'e':
+			trace_robot = strtol(optarg, NULL, 10);
+			break;
+		case 'o':
+			text_path = optarg;
+			break;
+		case 'b':
+			binary_path = optarg;
+			break;
+		default:
+			PrintUsage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (read_trace_path) {
+		return ReadTrace(read_trace_path, trace_robot);
+	}
+
+	csci3081::arena_params aparams;
+	if (!scenario_path) {
+		csci3081::InitDefaultArenaParams(&aparams);
+	}
+	else if (!csci3081::LoadScenario(scenario_path, &aparams)) {
+		return 1;
+	}
+	if (seeded) {
+		aparams.seed = seed;
+	}
+	if (timestep > 0) {
+		aparams.timestep = timestep;
+	}
+
+	if (text_path || binary_path) {
+		const char * path = text_path ? text_path : binary_path;
+		if (!csci3081::SaveScenario(path, aparams, text_path ?
+		                            csci3081::kScenarioText :
+		                            csci3081::kScenarioBinary)) {
+			fprintf(stderr, "Could not write the scenario to %s\n", path);
+			return 1;
+		}
+		return 0;
+	}
+
+	if (replay_path) {
+		return Replay(replay_path, eparams.arena_threads);
+	}
+	if (record_path) {
+		return Record(record_path, aparams, eparams);
+	}
+	if (trace_path) {
+		return Trace(trace_path, aparams, eparams);
+	}
+
+	std::vector<csci3081::arena_params> games(n_games, aparams);
+
+	csci3081::ensemble_stats stats;
+	std::vector<csci3081::game_result> results =
+		csci3081::RunEnsemble(games, eparams, &stats);
+
+	if (!quiet) {
+		for (size_t game = 0; game < results.size(); ++game) {
+			const char * outcome = "unfinished";
+			if (results[game].status == 1) {
+				outcome = "win";
+			}
+			else if (results[game].status == 0) {
+				outcome = "lose";
+			}
+			printf("game %zu: %s after %lu ticks\n", game, outcome,
+			       results[game].ticks);
+		}
+	}
+
+	printf("games: %lu  wins: %lu  losses: %lu  unfinished: %lu\n",
+	       n_games, stats.wins, stats.losses, stats.unfinished);
+	printf("ticks: %llu  seconds: %.6f  ticks/sec: %.0f\n",
+	       stats.total_ticks, stats.seconds,
+	       stats.seconds > 0 ? stats.total_ticks / stats.seconds : 0.0);
+	if (histogram) {
+		PrintHistogram("win", stats.win_ticks, stats.bucket_ticks);
+		PrintHistogram("lose", stats.loss_ticks, stats.bucket_ticks);
+	}
+	return 0;
+}
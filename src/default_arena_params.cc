@@ -0,0 +1,110 @@
+/**
+ * @file default_arena_params.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/default_arena_params.h"
+#include "src/color.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Fill in the parameters for the default game.
+ * @param params Arena parameters to populate
+ */
+void InitDefaultArenaParams(struct arena_params * const params) {
+	// Initialize default start values for various arena entities
+	player_params pparams;
+
+	pparams.angle_delta = 10;
+	pparams.collision_delta = 1;
+	pparams.radius = 20.0;
+	pparams.pos = Position(500, 500);
+	pparams.color = Color(0, 0, 255, 255); /* blue */
+	pparams.battery_max_charge = 100;
+
+	params->player = pparams;
+
+	params->recharge_station.radius = 20.0;
+	params->recharge_station.pos = {500, 300};
+	params->recharge_station.color = Color(0, 128, 128, 255); /* green */
+
+	params->home_base.angle_delta = 10;
+	params->home_base.collision_delta = 1;
+	params->home_base.radius = 20.0;
+	params->home_base.pos = {400, 400};
+	params->home_base.color = Color(255, 0, 0, 255); /* red */
+
+	const Position robot_pos[] = {
+		Position(700, 175), Position(800, 400), Position(175, 700),
+		Position(320, 277), Position(570, 630)
+	};
+	const size_t n_robots = sizeof(robot_pos) / sizeof(robot_pos[0]);
+
+	params->robots.clear();
+	params->robots.reserve(n_robots);
+	for (size_t i = 0; i < n_robots; ++i) {
+		robot_params rparam;
+
+		rparam.angle_delta = 10;
+		rparam.collision_delta = 1;
+		rparam.radius = 20.0;
+		rparam.pos = robot_pos[i];
+		rparam.starting_pos = robot_pos[i];
+		rparam.color = Color(0, 255, 255, 255);
+
+		params->robots.push_back(rparam);
+	}
+
+	// Each robot has a superbot waiting off to the side to be promoted to
+	params->superbots.clear();
+	params->superbots.reserve(n_robots);
+	for (size_t i = 0; i < n_robots; ++i) {
+		superbot_params sparam;
+
+		sparam.angle_delta = 10;
+		sparam.collision_delta = 1;
+		sparam.radius = 20.0;
+		sparam.pos = Position(0, 0);
+		sparam.starting_pos = Position(0, 0);
+		sparam.color = Color(255, 255, 0, 0);
+
+		params->superbots.push_back(sparam);
+	}
+
+	const double obstacle_radius[] = {30.0, 45.0, 20.0, 50.0, 30.0};
+	const Position obstacle_pos[] = {
+		Position(200, 200), Position(180, 400), Position(400, 520),
+		Position(600, 464), Position(450, 175)
+	};
+	const size_t n_obstacles = sizeof(obstacle_pos) / sizeof(obstacle_pos[0]);
+
+	params->obstacles.clear();
+	params->obstacles.reserve(n_obstacles);
+	for (size_t i = 0; i < n_obstacles; ++i) {
+		arena_entity_params oparam;
+
+		oparam.radius = obstacle_radius[i];
+		oparam.pos = obstacle_pos[i];
+		oparam.color = Color(255, 255, 255, 255); /* white */
+
+		params->obstacles.push_back(oparam);
+	}
+
+	params->x_dim = 1100;
+	params->y_dim = 740;
+	params->seed = 3081;
+	params->timestep = 1;
+}
+
+NAMESPACE_END(csci3081);
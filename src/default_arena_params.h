@@ -0,0 +1,37 @@
+/**
+ * @file default_arena_params.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_DEFAULT_ARENA_PARAMS_H_
+#define SRC_DEFAULT_ARENA_PARAMS_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/arena_params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Fill in the parameters for the default game: one player, a recharge
+ * station, a home base, five robots (each with a superbot to be promoted to)
+ * and five obstacles in a 1100x740 arena.
+ *
+ * Shared by the graphical viewer and the headless simulation runner so both
+ * play the same game.
+ *
+ * @param params Arena parameters to populate
+ */
+void InitDefaultArenaParams(struct arena_params * const params);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_DEFAULT_ARENA_PARAMS_H_
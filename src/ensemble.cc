@@ -0,0 +1,112 @@
+/**
+ * @file ensemble.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <utility>
+
+#include "src/ensemble.h"
+#include "src/arena.h"
+#include "src/worker_pool.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Count a finished game in a ticks-to-completion histogram.
+ */
+static void AddToHistogram(std::vector<unsigned long> * const histogram,
+                           unsigned long ticks, unsigned long bucket_ticks) {
+	size_t bucket = ticks / bucket_ticks;
+	if (histogram->size() <= bucket) {
+		histogram->resize(bucket + 1, 0);
+	}
+	++(*histogram)[bucket];
+}
+
+/**
+ * @brief Play one full game in a new arena per parameter set, several at a time
+ * on a pool of threads, and gather the outcomes.
+ * @param games Parameters of the arena for each game
+ * @param params How to play the games
+ * @param stats Filled with the outcome statistics of all the games
+ * @return std::vector<game_result> How each game ended, in the order of games
+ */
+std::vector<struct game_result> RunEnsemble(
+	const std::vector<struct arena_params>& games,
+	const struct ensemble_params& params, struct ensemble_stats * const stats) {
+	std::vector<struct game_result> results(games.size());
+	auto start = std::chrono::steady_clock::now();
+
+	// Hand out the random streams up front, in game order, so they don't
+	// depend on which worker gets to a game first
+	std::vector<RandomStream> streams;
+	streams.reserve(games.size());
+	std::map<uint64_t, RandomStream> last_stream;
+	for (const auto& game : games) {
+		auto it = last_stream.find(game.seed);
+		if (it == last_stream.end()) {
+			it = last_stream.insert(std::make_pair(game.seed,
+			                                       RandomStream(game.seed))).first;
+		}
+		else {
+			it->second.Jump();
+		}
+		streams.push_back(it->second);
+	}
+
+	// Games take very different numbers of ticks, so each worker takes the
+	// next unplayed game whenever it finishes one, rather than a fixed share.
+	std::atomic<size_t> next_game(0);
+	WorkerPool workers;
+	workers.Resize(params.n_threads);
+	workers.Run([&](__unused unsigned int t) {
+		for (size_t g = next_game++; g < games.size(); g = next_game++) {
+			Arena arena(&games[g]);
+			arena.set_threads(params.arena_threads);
+			arena.set_random(streams[g]);
+			int game_status = 2;
+			unsigned long ticks = 0;
+			while (game_status == 2 && ticks < params.max_ticks) {
+				game_status = arena.AdvanceTime();
+				++ticks;
+			}
+			results[g].status = game_status;
+			results[g].ticks = ticks;
+		}
+	});
+
+	*stats = ensemble_stats();
+	stats->seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+	stats->bucket_ticks = params.bucket_ticks > 0 ? params.bucket_ticks : 1;
+	for (const auto& result : results) {
+		stats->total_ticks += result.ticks;
+		if (result.status == 1) {
+			++stats->wins;
+			AddToHistogram(&stats->win_ticks, result.ticks, stats->bucket_ticks);
+		}
+		else if (result.status == 0) {
+			++stats->losses;
+			AddToHistogram(&stats->loss_ticks, result.ticks, stats->bucket_ticks);
+		}
+		else {
+			++stats->unfinished;
+		}
+	}
+	return results;
+}
+
+NAMESPACE_END(csci3081);
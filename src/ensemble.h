@@ -0,0 +1,93 @@
+/**
+ * @file ensemble.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ENSEMBLE_H_
+#define SRC_ENSEMBLE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <vector>
+#include "src/common.h"
+#include "src/arena_params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief How to play an ensemble of games.
+ */
+struct ensemble_params {
+	ensemble_params(void) : n_threads(1), arena_threads(1), max_ticks(1000000),
+		bucket_ticks(100) {
+	}
+
+	unsigned int n_threads; // number of games played at once
+	unsigned int arena_threads; // threads each game spreads its ticks across (see Arena::set_threads())
+	unsigned long max_ticks; // give up on a game after this many ticks
+	unsigned long bucket_ticks; // width of each ticks-to-completion histogram bucket
+};
+
+/**
+ * @brief How one game of an ensemble ended.
+ */
+struct game_result {
+	game_result(void) : status(2), ticks(0) {
+	}
+
+	int status; // last status from Arena::AdvanceTime() (0 = lose, 1 = win, 2 = unfinished)
+	unsigned long ticks; // number of ticks the game ran for
+};
+
+/**
+ * @brief Outcome statistics of an ensemble of games.
+ */
+struct ensemble_stats {
+	ensemble_stats(void) : wins(0), losses(0), unfinished(0), total_ticks(0),
+		bucket_ticks(0), win_ticks(), loss_ticks(), seconds(0) {
+	}
+
+	unsigned long wins; // games the player won
+	unsigned long losses; // games the player lost
+	unsigned long unfinished; // games given up on after max_ticks
+	unsigned long long total_ticks; // ticks run over all games
+	unsigned long bucket_ticks; // width of each histogram bucket in ticks
+	std::vector<unsigned long> win_ticks; // games won, by ticks to completion / bucket_ticks
+	std::vector<unsigned long> loss_ticks; // games lost, by ticks to completion / bucket_ticks
+	double seconds; // wall clock time the ensemble took
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Play one full game in a new arena per parameter set, several at a
+ * time on a pool of threads, and gather the outcomes.
+ *
+ * Each game has its own \ref Arena and shares nothing with the others, so the
+ * result of a game does not depend on how many are played at once. The first
+ * game with a given seed draws its random numbers from that seed, exactly as
+ * an arena built on its own would; each later game with the same seed gets
+ * the stream jumped ahead once more, so repeats of a parameter set play
+ * different, independent games.
+ *
+ * @param games Parameters of the arena for each game
+ * @param params How to play the games
+ * @param stats Filled with the outcome statistics of all the games
+ * @return std::vector<game_result> How each game ended, in the order of games
+ */
+std::vector<struct game_result> RunEnsemble(
+	const std::vector<struct arena_params>& games,
+	const struct ensemble_params& params, struct ensemble_stats * const stats);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENSEMBLE_H_
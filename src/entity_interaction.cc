@@ -0,0 +1,53 @@
+/**
+ * @file entity_interaction.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/entity_interaction.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+const struct entity_interaction_table kEntityInteractions;
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+/**
+ * @brief Fill in the response of every type of entity to every other type.
+ */
+entity_interaction_table::entity_interaction_table(void) : pairs() {
+	// By default, entities are avoided and bounced off
+	for (int self = 0; self <= kNone; ++self) {
+		for (int other = 0; other <= kNone; ++other) {
+			pairs[self][other].collision = kCollisionIgnore;
+			pairs[self][other].proximity = kProximityAvoid;
+		}
+	}
+
+	// Robots and superbots rescue frozen robots they run into, and steer
+	// around the ones that are still moving
+	const enum entity_type rescuers[] = {kRobot, kSuperBot};
+	for (auto self : rescuers) {
+		pairs[self][kRobot].collision = kCollisionUnfreeze;
+		pairs[self][kRobot].proximity = kProximityRobot;
+	}
+
+	// Robots head for home base, which promotes them to superbots
+	pairs[kRobot][kHomebase].proximity = kProximityContinue;
+
+	// Superbots steer around the player like anything else; the name check
+	// this replaced meant to send them after it, but never matched a superbot
+	pairs[kSuperBot][kPlayer].proximity = kProximityAvoid;
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,79 @@
+/**
+ * @file entity_interaction.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ENTITY_INTERACTION_H_
+#define SRC_ENTITY_INTERACTION_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/common.h"
+#include "src/entity_type.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief What a robot or superbot does when its proximity sensor picks up
+ * another entity.
+ */
+enum proximity_response {
+	kProximityAvoid, // turn away from it
+	kProximityContinue, // keep heading towards it, and report its type
+	kProximityRobot, // turn away from a moving robot; a frozen one is in distress
+};
+
+/**
+ * @brief What happens when a robot or superbot runs into another entity while
+ * the arena is looking for robots to rescue.
+ */
+enum collision_response {
+	kCollisionIgnore, // nothing, the general collision pass will bounce them
+	kCollisionUnfreeze, // the other entity is a robot, and is set moving again
+};
+
+/**
+ * @brief How an entity of one type responds to an entity of another.
+ */
+struct entity_interaction {
+	enum collision_response collision; // response to running into it
+	enum proximity_response proximity; // response to sensing it nearby
+};
+
+/**
+ * @brief The responses of every type of entity to every other type, indexed
+ * by [self][other]. Built once so the arena's inner loops can make their
+ * decisions with a lookup instead of comparing names or casting.
+ */
+struct entity_interaction_table {
+	entity_interaction_table(void);
+
+	struct entity_interaction pairs[kNone + 1][kNone + 1]; // [self][other]
+};
+
+extern const struct entity_interaction_table kEntityInteractions;
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Get how an entity responds to another.
+ * @param self Type of the entity responding
+ * @param other Type of the entity it is responding to
+ */
+inline const struct entity_interaction& GetInteraction(enum entity_type self,
+                                                       enum entity_type other) {
+	return kEntityInteractions.pairs[self][other];
+}
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENTITY_INTERACTION_H_
@@ -0,0 +1,127 @@
+/**
+ * @file entity_pool.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ENTITY_POOL_H_
+#define SRC_ENTITY_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A block of memory holding every entity of one type in an arena, next
+ * to each other.
+ *
+ * The \ref Arena reserves room for all of the entities of a type up front,
+ * with one allocation, and then creates them in place one after another, so a
+ * scene takes one allocation per type of entity however many entities it has.
+ * Entities stay where they were created until the pool is cleared or
+ * destroyed; resetting the game resets them in place (\ref ArenaEntity::Reset())
+ * rather than making new ones. Clearing the pool destroys all of its entities
+ * at once, and destroying it also gives the memory back.
+ */
+template <class T>
+class EntityPool {
+public:
+	/**
+	 * @brief EntityPool constructor. The pool has no room until \ref Reserve()
+	 * is called.
+	 */
+	EntityPool(void) : data_(nullptr), size_(0), capacity_(0) {
+	}
+
+	/**
+	 * @brief EntityPool destructor. Destroys every entity and frees the memory.
+	 */
+	~EntityPool(void) {
+		Clear();
+		::operator delete(data_);
+	}
+
+	EntityPool& operator=(const EntityPool& other) = delete;
+	EntityPool(const EntityPool& other) = delete;
+
+	/**
+	 * @brief Make room for a number of entities, in one allocation. Only an
+	 * empty pool can be given more room, since its entities must not move.
+	 * @param capacity Number of entities to make room for
+	 */
+	void Reserve(size_t capacity) {
+		assert(size_ == 0);
+		if (capacity <= capacity_) {
+			return;
+		}
+		::operator delete(data_);
+		data_ = static_cast<T*>(::operator new(capacity * sizeof(T)));
+		capacity_ = capacity;
+	}
+
+	/**
+	 * @brief Create an entity in the next free place in the pool.
+	 * @param args Arguments to the entity's constructor
+	 * @return T* The new entity, owned by the pool
+	 */
+	template <class... Args>
+	T* Create(Args&&... args) {
+		assert(size_ < capacity_);
+		T* ent = new (data_ + size_) T(std::forward<Args>(args)...);
+		++size_;
+		return ent;
+	}
+
+	/**
+	 * @brief Destroy every entity in the pool, in reverse order of creation,
+	 * keeping the memory for new ones.
+	 */
+	void Clear(void) {
+		while (size_ > 0) {
+			data_[--size_].~T();
+		}
+	}
+
+	/**
+	 * @brief Get the number of entities in the pool.
+	 */
+	size_t size(void) const {
+		return size_;
+	}
+
+	/**
+	 * @brief Get the number of entities the pool has room for.
+	 */
+	size_t capacity(void) const {
+		return capacity_;
+	}
+
+	/**
+	 * @brief Get the i-th entity created.
+	 */
+	T* operator[](size_t i) const {
+		return data_ + i;
+	}
+
+private:
+	T* data_; // the entities, in order of creation
+	size_t size_; // number of entities created
+	size_t capacity_; // number of entities there is room for
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENTITY_POOL_H_
@@ -0,0 +1,97 @@
+/**
+ * @file entity_span.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ENTITY_SPAN_H_
+#define SRC_ENTITY_SPAN_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <vector>
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A read-only, non-owning view of a list of entities of one type.
+ *
+ * The \ref Arena hands these out for the lists of entities it keeps, so
+ * callers (e.g. the viewer, every frame) can walk them without copying. A span
+ * is only valid until the arena's membership next changes (a robot is
+ * promoted or the arena is reset), so don't hold on to one across calls to
+ * \ref Arena::AdvanceTime() or \ref Arena::Reset().
+ */
+template <class T>
+class EntitySpan {
+public:
+	/**
+	 * @brief EntitySpan constructor, for an empty span.
+	 */
+	EntitySpan(void) : data_(nullptr), size_(0) {
+	}
+
+	/**
+	 * @brief EntitySpan constructor
+	 * @param entities The list of entities to view
+	 */
+	explicit EntitySpan(const std::vector<T*>& entities) :
+		data_(entities.data()), size_(entities.size()) {
+	}
+
+	EntitySpan(const EntitySpan& other) = default;
+	EntitySpan& operator=(const EntitySpan& other) = default;
+
+	/**
+	 * @brief Get the number of entities in the span.
+	 */
+	size_t size(void) const {
+		return size_;
+	}
+
+	/**
+	 * @brief Whether the span has no entities.
+	 */
+	bool empty(void) const {
+		return size_ == 0;
+	}
+
+	/**
+	 * @brief Get the i-th entity in the span.
+	 * @param i Index of the entity
+	 */
+	T * operator[](size_t i) const {
+		return data_[i];
+	}
+
+	/**
+	 * @brief Get an iterator to the first entity in the span.
+	 */
+	T * const * begin(void) const {
+		return data_;
+	}
+
+	/**
+	 * @brief Get an iterator past the last entity in the span.
+	 */
+	T * const * end(void) const {
+		return data_ + size_;
+	}
+
+private:
+	T * const * data_; // first entity in the span
+	size_t size_; // number of entities in the span
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENTITY_SPAN_H_
@@ -0,0 +1,152 @@
+/**
+ * @file entity_store.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/entity_store.h"
+#include "src/arena_mobile_entity.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+/**
+ * @brief Remove every entity from the store.
+ */
+void EntityStore::Clear(void) {
+	x.clear();
+	y.clear();
+	start_x.clear();
+	start_y.clear();
+	heading.clear();
+	speed.clear();
+	radius.clear();
+	collision_delta.clear();
+	type.clear();
+	entity.clear();
+}
+
+/**
+ * @brief Reserve room for n entities in every column.
+ * @param n Number of entities
+ */
+void EntityStore::Reserve(size_t n) {
+	x.reserve(n);
+	y.reserve(n);
+	start_x.reserve(n);
+	start_y.reserve(n);
+	heading.reserve(n);
+	speed.reserve(n);
+	radius.reserve(n);
+	collision_delta.reserve(n);
+	type.reserve(n);
+	entity.reserve(n);
+}
+
+/**
+ * @brief Append an entity to the store.
+ * @param ent The entity
+ * @return unsigned int The slot the entity was placed in
+ */
+unsigned int EntityStore::Add(ArenaEntity * ent) {
+	unsigned int i = entity.size();
+	x.push_back(0);
+	y.push_back(0);
+	start_x.push_back(0);
+	start_y.push_back(0);
+	heading.push_back(0);
+	speed.push_back(0);
+	radius.push_back(0);
+	collision_delta.push_back(0);
+	type.push_back(kNone);
+	entity.push_back(nullptr);
+	Replace(i, ent);
+	return i;
+}
+
+/**
+ * @brief Put a different entity in a slot, in place of the one there. No other
+ * slot moves.
+ * @param i Slot to fill
+ * @param ent The entity
+ */
+void EntityStore::Replace(unsigned int i, ArenaEntity * ent) {
+	enum entity_type t = ent->get_type();
+	radius[i] = ent->get_radius();
+	collision_delta[i] = IsMobile(t) ?
+		static_cast<ArenaMobileEntity*>(ent)->get_collision_delta() : 0;
+	heading[i] = 0;
+	speed[i] = 0;
+	type[i] = t;
+	entity[i] = ent;
+	Gather(i);
+}
+
+/**
+ * @brief Refresh the position, heading and speed columns of every slot from
+ * its entity, and start the tick there.
+ */
+void EntityStore::Gather(void) {
+	for (size_t i = 0; i < entity.size(); ++i) {
+		Gather(i);
+	}
+}
+
+/**
+ * @brief Refresh the position, heading and speed columns of one slot from its
+ * entity, and start the tick there.
+ * @param i Slot of the entity
+ */
+void EntityStore::Gather(unsigned int i) {
+	x[i] = entity[i]->get_pos().x();
+	y[i] = entity[i]->get_pos().y();
+	start_x[i] = x[i];
+	start_y[i] = y[i];
+	if (mobile(i)) {
+		const ArenaMobileEntity * ent = static_cast<ArenaMobileEntity*>(entity[i]);
+		heading[i] = ent->get_heading_angle();
+		speed[i] = ent->get_speed();
+	}
+}
+
+/**
+ * @brief Move the entity in a slot, in both the store and the entity.
+ * @param i Slot of the entity
+ * @param pos New position
+ */
+void EntityStore::set_pos(unsigned int i, const Position& pos) {
+	entity[i]->set_pos(pos);
+	x[i] = pos.x();
+	y[i] = pos.y();
+}
+
+/**
+ * @brief Turn the (mobile) entity in a slot, in both the store and the entity.
+ * @param i Slot of the entity
+ * @param h New heading angle in degrees
+ */
+void EntityStore::set_heading(unsigned int i, double h) {
+	static_cast<ArenaMobileEntity*>(entity[i])->set_heading_angle(h);
+	heading[i] = h;
+}
+
+/**
+ * @brief Change the speed of the (mobile) entity in a slot, in both the store
+ * and the entity.
+ * @param i Slot of the entity
+ * @param sp New speed
+ */
+void EntityStore::set_speed(unsigned int i, double sp) {
+	static_cast<ArenaMobileEntity*>(entity[i])->set_speed(sp);
+	speed[i] = sp;
+}
+
+NAMESPACE_END(csci3081);
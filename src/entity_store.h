@@ -0,0 +1,149 @@
+/**
+ * @file entity_store.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ENTITY_STORE_H_
+#define SRC_ENTITY_STORE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <vector>
+#include "src/common.h"
+#include "src/entity_type.h"
+#include "src/position.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+class ArenaEntity;
+
+/**
+ * @brief Structure-of-arrays copy of the state the \ref Arena reads every tick
+ * for movement, collision and proximity checks.
+ *
+ * Slot i of every column describes the same entity, entity[i]. Keeping each
+ * attribute in its own contiguous array lets the hot loops stream through
+ * just the numbers they need instead of chasing a pointer into each (large)
+ * entity object.
+ *
+ * The entity objects remain the public view of the simulation. \ref Gather()
+ * refreshes the dynamic columns from them, and the setters here write through
+ * to both the store and the entity so the two never disagree. Gathering a slot
+ * also marks where its entity starts the tick (start_x, start_y), so the
+ * collision checks can follow the path it moves along.
+ */
+struct EntityStore {
+	EntityStore(void) : x(), y(), start_x(), start_y(), heading(), speed(),
+		radius(), collision_delta(), type(), entity() {
+	}
+
+	/**
+	 * @brief Get the number of entities in the store.
+	 */
+	size_t size(void) const {
+		return entity.size();
+	}
+
+	/**
+	 * @brief Remove every entity from the store.
+	 */
+	void Clear(void);
+
+	/**
+	 * @brief Reserve room for n entities in every column.
+	 * @param n Number of entities
+	 */
+	void Reserve(size_t n);
+
+	/**
+	 * @brief Append an entity to the store.
+	 * @param ent The entity; its type decides whether it is treated as mobile
+	 * @return unsigned int The slot the entity was placed in
+	 */
+	unsigned int Add(class ArenaEntity * ent);
+
+	/**
+	 * @brief Put a different entity in a slot, in place of the one there. No
+	 * other slot moves.
+	 * @param i Slot to fill
+	 * @param ent The entity; its type decides whether it is treated as mobile
+	 */
+	void Replace(unsigned int i, class ArenaEntity * ent);
+
+	/**
+	 * @brief Refresh the position, heading and speed columns of every slot
+	 * from its entity, and start the tick there.
+	 */
+	void Gather(void);
+
+	/**
+	 * @brief Refresh the position, heading and speed columns of one slot from
+	 * its entity, and start the tick there.
+	 * @param i Slot of the entity
+	 */
+	void Gather(unsigned int i);
+
+	/**
+	 * @brief Whether the entity in a slot can move (player, home base, robots
+	 * and superbots).
+	 * @param i Slot of the entity
+	 */
+	bool mobile(unsigned int i) const {
+		return IsMobile(type[i]);
+	}
+
+	/**
+	 * @brief Move the entity in a slot, in both the store and the entity.
+	 * @param i Slot of the entity
+	 * @param pos New position
+	 */
+	void set_pos(unsigned int i, const Position& pos);
+
+	/**
+	 * @brief Turn the (mobile) entity in a slot, in both the store and the
+	 * entity.
+	 * @param i Slot of the entity
+	 * @param h New heading angle in degrees
+	 */
+	void set_heading(unsigned int i, double h);
+
+	/**
+	 * @brief Change the speed of the (mobile) entity in a slot, in both the
+	 * store and the entity.
+	 * @param i Slot of the entity
+	 * @param sp New speed
+	 */
+	void set_speed(unsigned int i, double sp);
+
+	/**
+	 * @brief Whether entities of a type can move.
+	 * @param t Type of entity
+	 */
+	static bool IsMobile(enum entity_type t) {
+		return t == kRobot || t == kSuperBot || t == kPlayer || t == kHomebase;
+	}
+
+	std::vector<double> x; // x coordinate of each entity
+	std::vector<double> y; // y coordinate of each entity
+	std::vector<double> start_x; // x coordinate of each entity at the start of the tick
+	std::vector<double> start_y; // y coordinate of each entity at the start of the tick
+	std::vector<double> heading; // heading angle of each entity in degrees (0 if immobile)
+	std::vector<double> speed; // speed of each entity (0 if immobile)
+	std::vector<double> radius; // radius of each entity in pixels
+	std::vector<double> collision_delta; // collision buffer of each entity (0 if immobile)
+	std::vector<enum entity_type> type; // type of each entity
+	std::vector<class ArenaEntity*> entity; // the entity each slot describes
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENTITY_STORE_H_
@@ -30,6 +30,7 @@ enum entity_type {
 	kPlayer,
 	kHomebase,
 	kRechargeStation,
+	kObstacle,
 	kWall,
 	kNone
 };
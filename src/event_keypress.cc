@@ -7,9 +7,8 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <assert.h>
 #include "src/event_keypress.h"
-#include "src/graphics_arena_viewer.h"
-#include "src/robot.h"
 
 /*******************************************************************************
  * Namespaces
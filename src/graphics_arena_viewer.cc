@@ -8,6 +8,8 @@
  * Includes
  ******************************************************************************/
 #include "src/graphics_arena_viewer.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -33,7 +35,9 @@ NAMESPACE_BEGIN(csci3081);
  */
 GraphicsArenaViewer::GraphicsArenaViewer(const struct arena_params* const params) :
 	csci3081::GraphicsApp(1100, 900, "Robot Simulation"), arena_(new Arena(params)),
-	paused_(false), pause_btn_(nullptr), battery_btn_(nullptr), last_dt(-1) {
+	paused_(false), pause_btn_(nullptr), battery_btn_(nullptr),
+	speed_btn_(nullptr), speed_(1), accumulator_(0), alpha_(0), robot_prev_pos_(),
+	player_prev_pos_(), home_base_prev_pos_() {
 
 	nanogui::FormHelper *gui = new nanogui::FormHelper(this);
 	nanogui::ref<nanogui::Window> window = gui->addWindow(Eigen::Vector2i(935, 760),
@@ -43,7 +47,14 @@ GraphicsArenaViewer::GraphicsArenaViewer(const struct arena_params* const params
 
 	battery_btn_ = gui->addButton("Battery:", std::bind(&GraphicsArenaViewer::OnBatteryBtnPressed, this));
 
-	last_dt = 0;
+	speed_btn_ = gui->addButton("Speed: 1x", std::bind(&GraphicsArenaViewer::OnSpeedBtnPressed, this));
+	nanogui::Slider *speed_slider = new nanogui::Slider(window);
+	speed_slider->setValue(0);
+	speed_slider->setCallback(std::bind(&GraphicsArenaViewer::OnSpeedSliderChanged,
+	                                    this, std::placeholders::_1));
+	gui->addWidget("", speed_slider);
+
+	SavePositions();
 	performLayout();
 }
 
@@ -55,31 +66,81 @@ GraphicsArenaViewer::GraphicsArenaViewer(const struct arena_params* const params
  * This is the primary driver for state change in the arena.
  * It will be called at each iteration of nanogui::mainloop()
  *
- * @param dt The # of timesteps that has elapsed since the last time
- *   position/velocity were updated.
+ * The arena always advances in fixed ticks of \ref kTickSeconds of game
+ * time. Each frame runs as many ticks as the elapsed time, scaled by the
+ * speed multiplier, covers (at most \ref kMaxTicksPerFrame) and carries the
+ * remainder over to the next frame.
+ *
+ * @param dt The # of seconds that have elapsed since the last frame.
  */
 void GraphicsArenaViewer::UpdateSimulation(double dt) {
-	if (!paused_) {
-		int game_status;
-		if ((last_dt + dt) > .05) {
-			game_status = arena_->AdvanceTime();
-			std::string battery = std::to_string(arena_->get_player_battery_level());
-			battery_btn_->setCaption(battery);
-			last_dt = 0;
-		}
-		else {
-			last_dt += dt;
-		}
+	if (paused_) {
+		return;
+	}
 
-		if (game_status == 0) {
-			pause_btn_->setCaption("You Lose :(");
-			paused_ = true;
-		}
-		else if (game_status == 1) {
-			pause_btn_->setCaption("You win :)");
-			paused_ = true;
+	// If the arena is falling behind, drop the time it can't catch up on this
+	// frame rather than letting it pile up
+	accumulator_ = std::min(accumulator_ + dt * speed_,
+	                        (kMaxTicksPerFrame + 1) * kTickSeconds);
+	unsigned int n_ticks = std::min(
+		static_cast<unsigned int>(accumulator_ / kTickSeconds), kMaxTicksPerFrame);
+
+	int game_status = 2;
+	for (unsigned int tick = 0; tick < n_ticks && game_status == 2; ++tick) {
+		// Only the last tick of the frame is interpolated, so only it needs
+		// the positions from before it
+		if (tick == n_ticks - 1) {
+			SavePositions();
 		}
+		game_status = arena_->AdvanceTime();
+		accumulator_ -= kTickSeconds;
+	}
+	alpha_ = std::min(accumulator_ / kTickSeconds, 1.0);
+
+	if (n_ticks > 0) {
+		std::string battery = std::to_string(arena_->get_player_battery_level());
+		battery_btn_->setCaption(battery);
+	}
+
+	if (game_status != 2) {
+		// Show the final state, not a frame between the last two ticks
+		SavePositions();
+		accumulator_ = 0;
+		alpha_ = 0;
+	}
+	if (game_status == 0) {
+		pause_btn_->setCaption("You Lose :(");
+		paused_ = true;
+	}
+	else if (game_status == 1) {
+		pause_btn_->setCaption("You win :)");
+		paused_ = true;
+	}
+}
+
+/**
+ * @brief Remember where the moving entities are, so the next tick can be
+ * drawn as a smooth move from here.
+ */
+void GraphicsArenaViewer::SavePositions(void) {
+	EntitySpan<Robot> robots = arena_->robots();
+	robot_prev_pos_.resize(robots.size());
+	for (size_t i = 0; i < robots.size(); i++) {
+		robot_prev_pos_[i] = robots[i]->get_pos();
 	}
+	player_prev_pos_ = arena_->player()->get_pos();
+	home_base_prev_pos_ = arena_->home_base()->get_pos();
+}
+
+/**
+ * @brief Get where to draw an entity this frame, part way between where it
+ * was before the last tick and where it is now.
+ */
+Position GraphicsArenaViewer::Interpolate(const Position& prev,
+                                          const Position& pos) const {
+	return Position(
+		static_cast<int>(std::lround(prev.x() + (pos.x() - prev.x()) * alpha_)),
+		static_cast<int>(std::lround(prev.y() + (pos.y() - prev.y()) * alpha_)));
 }
 
 /*******************************************************************************
@@ -90,6 +151,9 @@ void GraphicsArenaViewer::UpdateSimulation(double dt) {
  */
 void GraphicsArenaViewer::OnRestartBtnPressed() {
 	arena_->Reset();
+	SavePositions();
+	accumulator_ = 0;
+	alpha_ = 0;
 	pause_btn_->setCaption("Play");
 	paused_ = true;
 }
@@ -100,6 +164,21 @@ void GraphicsArenaViewer::OnRestartBtnPressed() {
 void GraphicsArenaViewer::OnBatteryBtnPressed() {
 }
 
+/**
+ * @brief Function that does nothing. Used to Bind speed presenter button to
+ */
+void GraphicsArenaViewer::OnSpeedBtnPressed() {
+}
+
+/**
+ * @brief Handle the user moving the speed slider on the GUI.
+ * @param value Slider position from 0 (1x) to 1 (1000x), on a log scale
+ */
+void GraphicsArenaViewer::OnSpeedSliderChanged(float value) {
+	speed_ = std::round(std::pow(kMaxSpeed, value));
+	speed_btn_->setCaption("Speed: " + std::to_string(static_cast<int>(speed_)) + "x");
+}
+
 /**
  * @brief Handle the user pressing the pause button on the GUI.
  */
@@ -238,13 +317,15 @@ void GraphicsArenaViewer::OnSpecialKeyUp(__unused int key,
  *
  * @param ctx The nanogui context.
  * @param robot The player handle.
+ * @param pos Where to draw the player.
  */
 void GraphicsArenaViewer::DrawPlayer(NVGcontext *ctx,
-                                     const Player* const player) {
+                                     const Player* const player,
+                                     const Position& pos) {
 	// translate and rotate all graphics calls that follow so that they are
 	// centered, at the position and heading for this robot
 	nvgSave(ctx);
-	nvgTranslate(ctx, player->get_pos().x(), player->get_pos().y());
+	nvgTranslate(ctx, pos.x(), pos.y());
 	nvgRotate(ctx, player->get_heading_angle());
 
 	// robot's circle
@@ -276,12 +357,14 @@ void GraphicsArenaViewer::DrawPlayer(NVGcontext *ctx,
  *
  * @param ctx The nanogui context.
  * @param robot The robot handle.
+ * @param pos Where to draw the robot.
  */
-void GraphicsArenaViewer::DrawRobot(NVGcontext *ctx, const Robot* const robot) {
+void GraphicsArenaViewer::DrawRobot(NVGcontext *ctx, const Robot* const robot,
+                                    const Position& pos) {
 	// translate and rotate all graphics calls that follow so that they are
 	// centered, at the position and heading for this robot
 	nvgSave(ctx);
-	nvgTranslate(ctx, robot->get_pos().x(), robot->get_pos().y());
+	nvgTranslate(ctx, pos.x(), pos.y());
 	nvgRotate(ctx, robot->get_heading_angle());
 
 	// robot's circle
@@ -337,10 +420,12 @@ void GraphicsArenaViewer::DrawObstacle(NVGcontext *ctx,
  *
  * @param ctx The nanogui context.
  * @param home The home base handle.
+ * @param pos Where to draw the home base.
  */
-void GraphicsArenaViewer::DrawHomeBase(NVGcontext *ctx, const HomeBase* const home) {
+void GraphicsArenaViewer::DrawHomeBase(NVGcontext *ctx, const HomeBase* const home,
+                                       const Position& pos) {
 	nvgBeginPath(ctx);
-	nvgCircle(ctx, home->get_pos().x(), home->get_pos().y(), home->get_radius());
+	nvgCircle(ctx, pos.x(), pos.y(), home->get_radius());
 	nvgFillColor(ctx, nvgRGBA(static_cast<int>(home->get_color().r),
 	                          static_cast<int>(home->get_color().g),
 	                          static_cast<int>(home->get_color().b),
@@ -350,8 +435,7 @@ void GraphicsArenaViewer::DrawHomeBase(NVGcontext *ctx, const HomeBase* const ho
 	nvgStroke(ctx);
 
 	nvgFillColor(ctx, nvgRGBA(0, 0, 0, 255));
-	nvgText(ctx, home->get_pos().x(), home->get_pos().y(),
-	        home->get_name().c_str(), NULL);
+	nvgText(ctx, pos.x(), pos.y(), home->get_name().c_str(), NULL);
 }
 
 /**
@@ -368,18 +452,27 @@ void GraphicsArenaViewer::DrawUsingNanoVG(NVGcontext *ctx) {
 	nvgFontFace(ctx, "sans-bold");
 	nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
 
-	std::vector<Obstacle*> obstacles = arena_->obstacles();
-	std::vector<Robot*> robots = arena_->robots();
+	EntitySpan<Obstacle> obstacles = arena_->obstacles();
+	EntitySpan<Robot> robots = arena_->robots();
 	for (size_t i = 0; i < obstacles.size(); i++) {
 		DrawObstacle(ctx, obstacles[i]);
 	}
 
+	// Draw the moving entities part way through the tick that is in progress,
+	// so motion looks smooth whatever the tick rate is. A robot with no
+	// position saved before the tick is drawn where it is.
 	for (size_t i = 0; i < robots.size(); i++) {
-		DrawRobot(ctx, robots[i]);
+		if (i < robot_prev_pos_.size()) {
+			DrawRobot(ctx, robots[i], Interpolate(robot_prev_pos_[i], robots[i]->get_pos()));
+		} else {
+			DrawRobot(ctx, robots[i], robots[i]->get_pos());
+		}
 	}
 
-	DrawPlayer(ctx, arena_->player());
-	DrawHomeBase(ctx, arena_->home_base());
+	DrawPlayer(ctx, arena_->player(),
+	           Interpolate(player_prev_pos_, arena_->player()->get_pos()));
+	DrawHomeBase(ctx, arena_->home_base(),
+	             Interpolate(home_base_prev_pos_, arena_->home_base()->get_pos()));
 }
 
 NAMESPACE_END(csci3081);
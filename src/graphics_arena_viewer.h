@@ -11,6 +11,7 @@
  * Includes
  ******************************************************************************/
 #include <simple_graphics/graphics_app.h>
+#include <vector>
 #include "src/arena.h"
 #include "src/common.h"
 
@@ -67,8 +68,13 @@ public:
 
 	/**
 	 * @brief Informs the arena of the new time, so that it can update.
-	 * @param dt The # of timesteps that has elapsed since the last time
-	 *   position/velocity were updated.
+	 *
+	 * The arena always advances in fixed ticks of \ref kTickSeconds of game
+	 * time. Each frame runs as many ticks as the elapsed time, scaled by the
+	 * speed multiplier, covers (at most \ref kMaxTicksPerFrame) and carries the
+	 * remainder over to the next frame.
+	 *
+	 * @param dt The # of seconds that have elapsed since the last frame.
 	 */
 	void UpdateSimulation(double dt) override;
 
@@ -87,6 +93,17 @@ public:
 	 */
 	void OnBatteryBtnPressed();
 
+	/**
+	 * @brief Function that does nothing. Used to Bind speed presenter button to
+	 */
+	void OnSpeedBtnPressed();
+
+	/**
+	 * @brief Handle the user moving the speed slider on the GUI.
+	 * @param value Slider position from 0 (1x) to 1 (1000x), on a log scale
+	 */
+	void OnSpeedSliderChanged(float value);
+
 	/**
 	 * @brief Called each time the mouse moves on the screen within the GUI
 	 * window.
@@ -197,7 +214,38 @@ public:
 		return arena_;
 	}
 
+	/**
+	 * @brief Game time, in seconds, that one tick of the arena stands for.
+	 */
+	static constexpr double kTickSeconds = 0.05;
+
+	/**
+	 * @brief Most ticks run in a single frame.
+	 *
+	 * If the arena can't keep up with the chosen speed, the time it falls
+	 * behind by is dropped instead of piling up, so the viewer stays
+	 * responsive and the game just runs slower than asked.
+	 */
+	static constexpr unsigned int kMaxTicksPerFrame = 1000;
+
+	/**
+	 * @brief Fastest speed multiplier the user can choose.
+	 */
+	static constexpr double kMaxSpeed = 1000;
+
 private:
+	/**
+	 * @brief Remember where the moving entities are, so the next tick can be
+	 * drawn as a smooth move from here.
+	 */
+	void SavePositions(void);
+
+	/**
+	 * @brief Get where to draw an entity this frame, part way between where it
+	 * was before the last tick and where it is now.
+	 */
+	Position Interpolate(const Position& prev, const Position& pos) const;
+
 	/**
 	 * @brief Draw a player using nanogui.
 	 *
@@ -206,8 +254,10 @@ private:
 	 *
 	 * @param ctx The nanogui context.
 	 * @param robot The player handle.
+	 * @param pos Where to draw the player.
 	 */
-	void DrawPlayer(NVGcontext *ctx, const class Player* const player);
+	void DrawPlayer(NVGcontext *ctx, const class Player* const player,
+	                const Position& pos);
 
 	/**
 	 * @brief Draw an obstacle in the arena using nanogui.
@@ -228,22 +278,32 @@ private:
 	 *
 	 * @param ctx The nanogui context.
 	 * @param robot The robot handle.
+	 * @param pos Where to draw the robot.
 	 */
-	void DrawRobot(NVGcontext *ctx, const Robot* const robot);
+	void DrawRobot(NVGcontext *ctx, const Robot* const robot,
+	               const Position& pos);
 
 	/**
 	 * @brief Draw the home base using nanogui.
 	 *
 	 * @param ctx The nanogui context.
 	 * @param home The home base handle.
+	 * @param pos Where to draw the home base.
 	 */
-	void DrawHomeBase(NVGcontext *ctx, const class HomeBase* const home);
+	void DrawHomeBase(NVGcontext *ctx, const class HomeBase* const home,
+	                  const Position& pos);
 
 	Arena *arena_; // Arena to bedisplaye with graphics
 	bool paused_; // holds whether game is paused or not
 	nanogui::Button *pause_btn_; // button to pause and unpause game
 	nanogui::Button *battery_btn_; // displays the player's battery level
-	double last_dt; // holds the time since the last update of GraphicsArenaViewer::UpdateSimulation
+	nanogui::Button *speed_btn_; // displays the speed multiplier
+	double speed_; // game seconds that pass per real second
+	double accumulator_; // game time not yet run as a tick
+	double alpha_; // how far between the last two ticks to draw, from 0 to 1
+	std::vector<Position> robot_prev_pos_; // robots' positions before the last tick
+	Position player_prev_pos_; // player's position before the last tick
+	Position home_base_prev_pos_; // home base's position before the last tick
 
 	// Satisfies compilers warning that the copy constructor should exist.
 	GraphicsArenaViewer& operator=(const GraphicsArenaViewer& other) = delete;
@@ -33,6 +33,7 @@ public:
 	 */
 	explicit HomeBase(const struct home_base_params* const params) :
 		Player(params) {
+		set_type(kHomebase);
 	}
 
 	/**
@@ -0,0 +1,222 @@
+/**
+ * @file input_log.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <assert.h>
+#include <chrono>
+#include <cstdio>
+
+#include "src/input_log.h"
+#include "src/arena.h"
+#include "src/arena_params_stream.h"
+#include "src/state_stream.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+// First bytes of every input log file, and the version of its layout
+static const uint32_t kInputLogMagic = 0x4e494152; // "RAIN"
+static const uint32_t kInputLogVersion = 1;
+
+// Bytes each input takes in the file: its tick and its key
+static const size_t kEventSize = sizeof(uint64_t) + sizeof(int32_t);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Whether an input can be applied to an arena: a reset, or one of the
+ * arrow keys EventKeypress knows.
+ */
+static bool IsKnownInput(int32_t key) {
+	return key == InputLog::kReset || (key >= 262 && key <= 265);
+}
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+/**
+ * @brief InputLog constructor
+ */
+InputLog::InputLog(void) : params_(), events_(), ticks_(0), state_hash_(0) {
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+/**
+ * @brief Start a new recording, throwing away anything recorded before.
+ * @param params Parameters of the arena the game is played in
+ */
+void InputLog::Start(const struct arena_params& params) {
+	params_ = params;
+	events_.clear();
+	ticks_ = 0;
+	state_hash_ = 0;
+}
+
+/**
+ * @brief Record an input.
+ * @param tick Ticks the arena had played when the input came in
+ * @param key Key passed to Arena::Accept(), or kReset
+ */
+void InputLog::Record(uint64_t tick, int32_t key) {
+	assert(events_.empty() || events_.back().tick <= tick);
+	input_event e;
+	e.tick = tick;
+	e.key = key;
+	events_.push_back(e);
+}
+
+/**
+ * @brief Note the tick count and state hash the arena ended at.
+ * @param arena The arena the game was recorded from
+ */
+void InputLog::Finish(const class Arena& arena) {
+	ticks_ = arena.ticks();
+	state_hash_ = arena.StateHash();
+}
+
+/**
+ * @brief Write the log to a file.
+ * @param path Path of the file, which is replaced if it exists
+ * @return bool Whether the whole file was written
+ */
+bool InputLog::Save(const char * path) const {
+	std::vector<uint8_t> bytes;
+	StateWriter w(&bytes);
+	w.Write(kInputLogMagic);
+	w.Write(kInputLogVersion);
+	SaveArenaParams(params_, &w);
+	w.Write(static_cast<uint64_t>(events_.size()));
+	for (const auto& e : events_) {
+		w.Write(e.tick);
+		w.Write(e.key);
+	}
+	w.Write(ticks_);
+	w.Write(state_hash_);
+
+	FILE * f = fopen(path, "wb");
+	if (!f) {
+		return false;
+	}
+	bool written = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+	return fclose(f) == 0 && written;
+}
+
+/**
+ * @brief Read a log from a file Save() wrote, replacing this one.
+ * @param path Path of the file
+ * @return bool Whether the file could be read and holds a whole log that can
+ * be replayed
+ */
+bool InputLog::Load(const char * path) {
+	FILE * f = fopen(path, "rb");
+	if (!f) {
+		return false;
+	}
+	std::vector<uint8_t> bytes;
+	uint8_t buf[1 << 16];
+	size_t n;
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+		bytes.insert(bytes.end(), buf, buf + n);
+	}
+	bool read = !ferror(f);
+	fclose(f);
+	if (!read) {
+		return false;
+	}
+
+	StateReader r(bytes.data(), bytes.size());
+	uint32_t magic = 0, version = 0;
+	r.Read(&magic);
+	r.Read(&version);
+	if (magic != kInputLogMagic || version != kInputLogVersion) {
+		return false;
+	}
+	struct arena_params params;
+	uint64_t n_events = 0;
+	if (!LoadArenaParams(&r, &params) || !r.Read(&n_events) ||
+	    n_events > r.remaining() / kEventSize) {
+		return false;
+	}
+	std::vector<struct input_event> events(n_events);
+	for (auto& e : events) {
+		r.Read(&e.tick);
+		r.Read(&e.key);
+	}
+	uint64_t ticks = 0, state_hash = 0;
+	r.Read(&ticks);
+	r.Read(&state_hash);
+	if (r.failed() || r.remaining() != 0) {
+		return false;
+	}
+
+	// The inputs have to be ones the arena takes, in the order they came in,
+	// and all before the end of the game
+	uint64_t last_tick = 0;
+	for (const auto& e : events) {
+		if (!IsKnownInput(e.key) || e.tick < last_tick) {
+			return false;
+		}
+		last_tick = e.tick;
+	}
+	if (last_tick > ticks) {
+		return false;
+	}
+
+	params_ = params;
+	events_.swap(events);
+	ticks_ = ticks;
+	state_hash_ = state_hash;
+	return true;
+}
+
+/**
+ * @brief Play a recorded game again in a new arena without any graphics, as
+ * fast as the CPU allows, and check it ends in the same state.
+ * @param log The recorded game
+ * @param n_threads Threads to spread each tick across
+ * @return replay_result How long the replay took and whether it matched
+ */
+struct replay_result ReplayInputLog(const InputLog& log,
+                                    unsigned int n_threads) {
+	struct replay_result result;
+	Arena arena(&log.params());
+	arena.set_threads(n_threads);
+
+	auto start = std::chrono::steady_clock::now();
+	for (const auto& e : log.events()) {
+		while (arena.ticks() < e.tick) {
+			arena.AdvanceTime();
+		}
+		if (e.key == InputLog::kReset) {
+			arena.Reset();
+		}
+		else {
+			arena.Accept(e.key);
+		}
+	}
+	while (arena.ticks() < log.ticks()) {
+		arena.AdvanceTime();
+	}
+	result.seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+
+	result.ticks = arena.ticks();
+	result.state_hash = arena.StateHash();
+	result.matched = result.state_hash == log.state_hash();
+	return result;
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,175 @@
+/**
+ * @file input_log.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_INPUT_LOG_H_
+#define SRC_INPUT_LOG_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <vector>
+#include "src/common.h"
+#include "src/arena_params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+class Arena;
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief One input to an arena: a key press or a reset.
+ */
+struct input_event {
+	input_event(void) : tick(0), key(0) {
+	}
+
+	uint64_t tick; // ticks the arena had played when the input came in
+	int32_t key; // key passed to Arena::Accept(), or InputLog::kReset
+};
+
+/**
+ * @brief How a replay of an \ref InputLog went.
+ */
+struct replay_result {
+	replay_result(void) : ticks(0), seconds(0), state_hash(0), matched(false) {
+	}
+
+	uint64_t ticks; // ticks the replay played
+	double seconds; // wall clock time the replay took
+	uint64_t state_hash; // Arena::StateHash() at the end of the replay
+	bool matched; // whether state_hash is the one the log ended with
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A recording of a game: the arena_params it was played with (seed
+ * included), every key press and reset with the tick it came in at, and the
+ * tick count and \ref Arena::StateHash() it ended at.
+ *
+ * The arena is deterministic, so those inputs are all it takes to play the
+ * same game again, with \ref ReplayInputLog(), and the hash shows whether it
+ * did. An arena records into a log once handed it with
+ * \ref Arena::set_input_log(); \ref Finish() then notes where the game ended.
+ *
+ * The file a log is saved to holds the parameters and the inputs as raw
+ * numbers (see \ref StateWriter), 12 bytes per input, so it can only be read
+ * back on a machine of the same byte order.
+ */
+class InputLog {
+public:
+	/**
+	 * @brief Key recorded for \ref Arena::Reset().
+	 */
+	static const int32_t kReset = -1;
+
+	/**
+	 * @brief InputLog constructor. The log is empty until \ref Start() or
+	 * \ref Load() is called.
+	 */
+	InputLog(void);
+
+	/**
+	 * @brief Start a new recording, throwing away anything recorded before.
+	 * @param params Parameters of the arena the game is played in, which must
+	 * be newly built from them
+	 */
+	void Start(const struct arena_params& params);
+
+	/**
+	 * @brief Record an input. Inputs must be recorded in the order they come
+	 * in.
+	 * @param tick Ticks the arena had played when the input came in
+	 * @param key Key passed to \ref Arena::Accept(), or \ref kReset
+	 */
+	void Record(uint64_t tick, int32_t key);
+
+	/**
+	 * @brief Note the tick count and state hash the arena ended at, for the
+	 * replay to check against.
+	 * @param arena The arena the game was recorded from
+	 */
+	void Finish(const class Arena& arena);
+
+	/**
+	 * @brief Write the log to a file.
+	 * @param path Path of the file, which is replaced if it exists
+	 * @return bool Whether the whole file was written
+	 */
+	bool Save(const char * path) const;
+
+	/**
+	 * @brief Read a log from a file \ref Save() wrote, replacing this one.
+	 * @param path Path of the file
+	 * @return bool Whether the file could be read and holds a whole log that
+	 * can be replayed; if not, the log is left as it was
+	 */
+	bool Load(const char * path);
+
+	/**
+	 * @brief Get the parameters of the arena the game was played in.
+	 */
+	const struct arena_params& params(void) const {
+		return params_;
+	}
+
+	/**
+	 * @brief Get the inputs recorded, in the order they came in.
+	 */
+	const std::vector<struct input_event>& events(void) const {
+		return events_;
+	}
+
+	/**
+	 * @brief Get the number of ticks the game ended at.
+	 */
+	uint64_t ticks(void) const {
+		return ticks_;
+	}
+
+	/**
+	 * @brief Get the state hash the game ended at.
+	 */
+	uint64_t state_hash(void) const {
+		return state_hash_;
+	}
+
+private:
+	struct arena_params params_; // parameters of the arena the game was played in
+	std::vector<struct input_event> events_; // inputs, in the order they came in
+	uint64_t ticks_; // ticks played by the end of the game
+	uint64_t state_hash_; // Arena::StateHash() at the end of the game
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Play a recorded game again in a new arena without any graphics, as
+ * fast as the CPU allows, and check it ends in the same state.
+ *
+ * Each input is applied once the arena has played as many ticks as it had
+ * when the input was recorded, and the arena is then played on to the tick
+ * count the recording ended at.
+ *
+ * @param log The recorded game
+ * @param n_threads Threads to spread each tick across (see
+ * \ref Arena::set_threads()); the outcome doesn't depend on it
+ * @return replay_result How long the replay took and whether it matched
+ */
+struct replay_result ReplayInputLog(const InputLog& log,
+                                    unsigned int n_threads);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_INPUT_LOG_H_
@@ -0,0 +1,203 @@
+/**
+ * @file kinematics.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cmath>
+#include "src/kinematics.h"
+
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define KINEMATICS_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define KINEMATICS_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Get the cosine and sine of a heading exactly as
+ * RobotMotionBehavior::UpdatePosition() does: the standard library's, of the
+ * angle converted to radians the same way. Any other approximation, however
+ * close, rounds some positions to a different pixel (a heading of 60 at speed
+ * 2 moves x by 1 or by 0 depending on the last bit of the cosine).
+ */
+static inline void HeadingCosSin(double heading, double * c, double * s) {
+	double angle = heading * M_PI / 180.0;
+	*c = cos(angle);
+	*s = sin(angle);
+}
+
+/**
+ * @brief Move a single entity along its heading. The vector versions below
+ * perform exactly these operations, lane by lane, and use this for the
+ * entities left over at the end of the arrays.
+ */
+static inline void IntegrateOne(double heading, double speed, double * x,
+                                double * y, double dt) {
+	double c, s;
+	HeadingCosSin(heading, &c, &s);
+	*x = static_cast<int>(*x + c * speed * dt);
+	*y = static_cast<int>(*y + s * speed * dt);
+}
+
+/**
+ * @brief Scalar kernel.
+ */
+static void IntegrateScalar(const double * heading, const double * speed,
+                            double * x, double * y, size_t n, double dt) {
+	for (size_t i = 0; i < n; ++i) {
+		IntegrateOne(heading[i], speed[i], &x[i], &y[i], dt);
+	}
+}
+
+#ifdef KINEMATICS_SSE2
+/**
+ * @brief SSE2 kernel, 2 entities per iteration.
+ */
+static void IntegrateSSE2(const double * heading, const double * speed,
+                          double * x, double * y, size_t n, double dt) {
+	const __m128d vdt = _mm_set1_pd(dt);
+	alignas(16) double cosines[2];
+	alignas(16) double sines[2];
+
+	size_t i = 0;
+	for (; i + 2 <= n; i += 2) {
+		HeadingCosSin(heading[i], &cosines[0], &sines[0]);
+		HeadingCosSin(heading[i + 1], &cosines[1], &sines[1]);
+		__m128d c = _mm_load_pd(cosines);
+		__m128d s = _mm_load_pd(sines);
+
+		__m128d sp = _mm_loadu_pd(speed + i);
+		__m128d nx = _mm_add_pd(_mm_loadu_pd(x + i), _mm_mul_pd(_mm_mul_pd(c, sp), vdt));
+		__m128d ny = _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(_mm_mul_pd(s, sp), vdt));
+		_mm_storeu_pd(x + i, _mm_cvtepi32_pd(_mm_cvttpd_epi32(nx)));
+		_mm_storeu_pd(y + i, _mm_cvtepi32_pd(_mm_cvttpd_epi32(ny)));
+	}
+	IntegrateScalar(heading + i, speed + i, x + i, y + i, n - i, dt);
+}
+#endif  // KINEMATICS_SSE2
+
+#ifdef KINEMATICS_AVX2
+/**
+ * @brief AVX2 kernel, 4 entities per iteration. Only called once the CPU has
+ * been checked for AVX2.
+ */
+__attribute__((target("avx2")))
+static void IntegrateAVX2(const double * heading, const double * speed,
+                          double * x, double * y, size_t n, double dt) {
+	const __m256d vdt = _mm256_set1_pd(dt);
+	alignas(32) double cosines[4];
+	alignas(32) double sines[4];
+
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		for (size_t k = 0; k < 4; ++k) {
+			HeadingCosSin(heading[i + k], &cosines[k], &sines[k]);
+		}
+		__m256d c = _mm256_load_pd(cosines);
+		__m256d s = _mm256_load_pd(sines);
+
+		__m256d sp = _mm256_loadu_pd(speed + i);
+		__m256d nx = _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_mul_pd(_mm256_mul_pd(c, sp), vdt));
+		__m256d ny = _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_mul_pd(_mm256_mul_pd(s, sp), vdt));
+		_mm256_storeu_pd(x + i, _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(nx)));
+		_mm256_storeu_pd(y + i, _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(ny)));
+	}
+	IntegrateScalar(heading + i, speed + i, x + i, y + i, n - i, dt);
+}
+#endif  // KINEMATICS_AVX2
+
+/**
+ * @brief Whether the kernel can be run with an instruction set on this CPU.
+ * @param isa Instruction set
+ */
+bool KinematicsIsaSupported(enum kinematics_isa isa) {
+	switch (isa) {
+	case kKinematicsScalar:
+		return true;
+#ifdef KINEMATICS_SSE2
+	case kKinematicsSSE2:
+		return true;
+#endif
+#ifdef KINEMATICS_AVX2
+	case kKinematicsAVX2:
+		return __builtin_cpu_supports("avx2");
+#endif
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Get the fastest instruction set the kernel supports on this CPU.
+ */
+enum kinematics_isa KinematicsBestIsa(void) {
+	static const enum kinematics_isa best =
+	    KinematicsIsaSupported(kKinematicsAVX2) ? kKinematicsAVX2 :
+	    KinematicsIsaSupported(kKinematicsSSE2) ? kKinematicsSSE2 :
+	    kKinematicsScalar;
+	return best;
+}
+
+/**
+ * @brief Get a printable name for an instruction set.
+ * @param isa Instruction set
+ */
+const char * KinematicsIsaName(enum kinematics_isa isa) {
+	switch (isa) {
+	case kKinematicsSSE2:
+		return "sse2";
+	case kKinematicsAVX2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
+
+/**
+ * @brief Move a batch of entities along their headings, using the fastest
+ * instruction set available.
+ */
+void IntegratePositions(const double * heading, const double * speed,
+                        double * x, double * y, size_t n, unsigned int dt) {
+	IntegratePositions(KinematicsBestIsa(), heading, speed, x, y, n, dt);
+}
+
+/**
+ * @brief Move a batch of entities along their headings, using a specific
+ * instruction set.
+ */
+void IntegratePositions(enum kinematics_isa isa, const double * heading,
+                        const double * speed, double * x, double * y,
+                        size_t n, unsigned int dt) {
+	switch (isa) {
+#ifdef KINEMATICS_AVX2
+	case kKinematicsAVX2:
+		IntegrateAVX2(heading, speed, x, y, n, dt);
+		break;
+#endif
+#ifdef KINEMATICS_SSE2
+	case kKinematicsSSE2:
+		IntegrateSSE2(heading, speed, x, y, n, dt);
+		break;
+#endif
+	default:
+		IntegrateScalar(heading, speed, x, y, n, dt);
+		break;
+	}
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,87 @@
+/**
+ * @file kinematics.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_KINEMATICS_H_
+#define SRC_KINEMATICS_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief Instruction sets the batched kernels (position integration here,
+ * \ref CircleHitMask() in narrow_phase.h) can be run with.
+ */
+enum kinematics_isa {
+	kKinematicsScalar, // plain C++, runs anywhere
+	kKinematicsSSE2, // 2 entities at a time (x86)
+	kKinematicsAVX2, // 4 entities at a time (x86, checked at run time)
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Get the fastest instruction set the kernel supports on this CPU.
+ */
+enum kinematics_isa KinematicsBestIsa(void);
+
+/**
+ * @brief Whether the kernel can be run with an instruction set on this CPU.
+ * @param isa Instruction set
+ */
+bool KinematicsIsaSupported(enum kinematics_isa isa);
+
+/**
+ * @brief Get a printable name for an instruction set.
+ * @param isa Instruction set
+ */
+const char * KinematicsIsaName(enum kinematics_isa isa);
+
+/**
+ * @brief Move a batch of entities along their headings, in one pass over
+ * contiguous arrays.
+ *
+ * This is the batched equivalent of RobotMotionBehavior::UpdatePosition():
+ * each position advances by speed * dt along its heading and is then
+ * truncated to whole pixels, as storing it in a \ref Position would do. The
+ * sines and cosines are the standard library's, as UpdatePosition() uses, so
+ * every entity lands on exactly the pixel it would have moved to on its own.
+ * The instruction sets only differ in how many entities the arithmetic around
+ * them is done for at once, with the same operations in the same order, so
+ * the results are bit-identical no matter which one the CPU picks.
+ *
+ * @param heading Heading angle of each entity in degrees
+ * @param speed Speed of each entity in pixels per timestep
+ * @param x The x coordinate of each entity, updated in place
+ * @param y The y coordinate of each entity, updated in place
+ * @param n Number of entities
+ * @param dt The # of timesteps to advance
+ */
+void IntegratePositions(const double * heading, const double * speed,
+                        double * x, double * y, size_t n, unsigned int dt);
+
+/**
+ * @brief \ref IntegratePositions() using a specific instruction set, which
+ * must be supported by the CPU (see \ref KinematicsIsaSupported()).
+ */
+void IntegratePositions(enum kinematics_isa isa, const double * heading,
+                        const double * speed, double * x, double * y,
+                        size_t n, unsigned int dt);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_KINEMATICS_H_
@@ -0,0 +1,251 @@
+/**
+ * @file kinematics_bench.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "src/arena_params.h"
+#include "src/default_arena_params.h"
+#include "src/kinematics.h"
+#include "src/robot.h"
+#include "src/robot_motion_behavior.h"
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Print the command line usage of the kinematics micro-benchmark.
+ * @param prog Name the program was invoked with
+ */
+static void PrintUsage(const char * prog) {
+	fprintf(stderr,
+	        "Usage: %s [-n entities] [-i iterations]\n"
+	        "  -n entities    Number of robots to move (default 4096)\n"
+	        "  -i iterations  Number of timesteps to time (default 2000)\n",
+	        prog);
+}
+
+/**
+ * @brief Put every robot back where it started, so each run begins from the
+ * same state.
+ */
+static void ResetRobots(const std::vector<csci3081::Robot*>& robots,
+                        const std::vector<csci3081::Position>& start) {
+	for (size_t i = 0; i < robots.size(); ++i) {
+		robots[i]->set_pos(start[i]);
+	}
+}
+
+/**
+ * @brief Count the moves an instruction set puts somewhere other than
+ * RobotMotionBehavior::UpdatePosition() does, over every whole-degree heading
+ * at every speed from 0 to 10 and 1 to 4 timesteps, from a few starting
+ * points. Headings such as 0, 30, 45, 60 and 90 are where a sine or cosine
+ * that is off by an ulp shows: their moves often come out at a whole number
+ * of pixels, and close to the origin, where that ulp isn't rounded away, the
+ * truncation to pixels turns the last bit into a pixel.
+ * @param isa Instruction set
+ * @param robot A robot to move one at a time
+ * @param n_moves Set to the number of moves compared
+ */
+static unsigned long CountWholeDegreeMismatches(enum csci3081::kinematics_isa isa,
+                                                csci3081::Robot * robot,
+                                                unsigned long * n_moves) {
+	const csci3081::Position starts[] = {
+		csci3081::Position(0, 0), csci3081::Position(3, 5),
+		csci3081::Position(500, 400)
+	};
+	csci3081::RobotMotionBehavior behavior;
+	std::vector<double> heading, speed, x, y;
+	std::vector<csci3081::Position> ref;
+	unsigned long mismatches = 0;
+	*n_moves = 0;
+	for (const auto& start : starts) {
+		for (unsigned int dt = 1; dt <= 4; ++dt) {
+			heading.clear();
+			speed.clear();
+			ref.clear();
+			for (int h = 0; h < 360; ++h) {
+				for (int sp = 0; sp <= 10; ++sp) {
+					robot->set_pos(start);
+					robot->set_heading_angle(h);
+					robot->set_speed(sp);
+					behavior.UpdatePosition(robot, dt);
+					heading.push_back(h);
+					speed.push_back(sp);
+					ref.push_back(robot->get_pos());
+				}
+			}
+			x.assign(heading.size(), start.x());
+			y.assign(heading.size(), start.y());
+			csci3081::IntegratePositions(isa, heading.data(), speed.data(),
+			                             x.data(), y.data(), heading.size(), dt);
+			for (size_t i = 0; i < heading.size(); ++i) {
+				mismatches += x[i] != ref[i].x() || y[i] != ref[i].y();
+			}
+			*n_moves += heading.size();
+		}
+	}
+	return mismatches;
+}
+
+/**
+ * @brief Print the time one way of moving the robots took.
+ */
+static void Report(const char * name, std::chrono::steady_clock::duration elapsed,
+                   unsigned long n_moves) {
+	double seconds = std::chrono::duration<double>(elapsed).count();
+	printf("%-24s %10.3f ns/entity  %8.1f M entities/sec\n", name,
+	       seconds * 1e9 / n_moves, n_moves / seconds / 1e6);
+}
+
+/**
+ * @brief Time moving a crowd of robots along their headings, first one at a
+ * time through RobotMotionBehavior::UpdatePosition() (the path the entities
+ * use on their own) and then in batches through IntegratePositions() with
+ * each instruction set the CPU supports.
+ */
+int main(int argc, char **argv) {
+	unsigned long n = 4096;
+	unsigned long iterations = 2000;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:i:h")) != -1) {
+		switch (opt) {
+		case 'n':
+			n = strtoul(optarg, NULL, 10);
+			break;
+		case 'i':
+			iterations = strtoul(optarg, NULL, 10);
+			break;
+		default:
+			PrintUsage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	csci3081::arena_params aparams;
+	csci3081::InitDefaultArenaParams(&aparams);
+
+	// A crowd of robots facing every which way, at assorted speeds
+	std::vector<csci3081::Robot*> robots;
+	std::vector<csci3081::Position> start;
+	srand(3081);
+	for (unsigned long i = 0; i < n; ++i) {
+		csci3081::Robot * r = new csci3081::Robot(&aparams.robots[i % aparams.robots.size()]);
+		r->set_pos(csci3081::Position(rand() % 1024, rand() % 768));
+		r->set_heading_angle((rand() % 36000) / 100.0);
+		r->set_speed(1 + rand() % 10);
+		robots.push_back(r);
+		start.push_back(r->get_pos());
+	}
+	unsigned long n_moves = n * iterations;
+	printf("entities: %lu  iterations: %lu\n", n, iterations);
+
+	// Current path: one entity at a time, through virtual getters
+	csci3081::RobotMotionBehavior behavior;
+	auto begin = std::chrono::steady_clock::now();
+	for (unsigned long it = 0; it < iterations; ++it) {
+		for (auto r : robots) {
+			behavior.UpdatePosition(r, 1);
+		}
+	}
+	Report("per-entity", std::chrono::steady_clock::now() - begin, n_moves);
+
+	// Positions after one step of the current path, to compare against
+	ResetRobots(robots, start);
+	std::vector<double> ref_x(n), ref_y(n);
+	for (unsigned long i = 0; i < n; ++i) {
+		behavior.UpdatePosition(robots[i], 1);
+		ref_x[i] = robots[i]->get_pos().x();
+		ref_y[i] = robots[i]->get_pos().y();
+	}
+
+	std::vector<double> heading(n), speed(n), x(n), y(n);
+	std::vector<double> first_x, first_y;
+	csci3081::Robot probe(&aparams.robots[0]);
+	const enum csci3081::kinematics_isa isas[] = {
+		csci3081::kKinematicsScalar, csci3081::kKinematicsSSE2,
+		csci3081::kKinematicsAVX2
+	};
+	for (auto isa : isas) {
+		if (!csci3081::KinematicsIsaSupported(isa)) {
+			printf("%-24s not supported on this CPU\n",
+			       csci3081::KinematicsIsaName(isa));
+			continue;
+		}
+		for (unsigned long i = 0; i < n; ++i) {
+			heading[i] = robots[i]->get_heading_angle();
+			speed[i] = robots[i]->get_speed();
+			x[i] = start[i].x();
+			y[i] = start[i].y();
+		}
+
+		// The kernel alone, on arrays that are already laid out for it
+		begin = std::chrono::steady_clock::now();
+		for (unsigned long it = 0; it < iterations; ++it) {
+			csci3081::IntegratePositions(isa, heading.data(), speed.data(),
+			                             x.data(), y.data(), n, 1);
+		}
+		Report(csci3081::KinematicsIsaName(isa),
+		       std::chrono::steady_clock::now() - begin, n_moves);
+
+		// One step from the starting positions, to check the results
+		for (unsigned long i = 0; i < n; ++i) {
+			x[i] = start[i].x();
+			y[i] = start[i].y();
+		}
+		csci3081::IntegratePositions(isa, heading.data(), speed.data(),
+		                             x.data(), y.data(), n, 1);
+		if (first_x.empty()) {
+			first_x = x;
+			first_y = y;
+		}
+		unsigned long differ_isa = 0, differ_ref = 0;
+		for (unsigned long i = 0; i < n; ++i) {
+			differ_isa += x[i] != first_x[i] || y[i] != first_y[i];
+			differ_ref += x[i] != ref_x[i] || y[i] != ref_y[i];
+		}
+		printf("%-24s %lu/%lu positions differ from scalar, %lu from per-entity\n",
+		       "", differ_isa, n, differ_ref);
+		unsigned long n_whole = 0;
+		unsigned long differ_whole = CountWholeDegreeMismatches(isa, &probe,
+		                                                        &n_whole);
+		printf("%-24s %lu/%lu whole-degree moves differ from per-entity\n",
+		       "", differ_whole, n_whole);
+	}
+
+	// What the arena does every tick: gather from the entities, run the
+	// kernel and write the new positions back
+	ResetRobots(robots, start);
+	begin = std::chrono::steady_clock::now();
+	for (unsigned long it = 0; it < iterations; ++it) {
+		for (unsigned long i = 0; i < n; ++i) {
+			heading[i] = robots[i]->get_heading_angle();
+			speed[i] = robots[i]->get_speed();
+			x[i] = robots[i]->get_pos().x();
+			y[i] = robots[i]->get_pos().y();
+		}
+		csci3081::IntegratePositions(heading.data(), speed.data(),
+		                             x.data(), y.data(), n, 1);
+		for (unsigned long i = 0; i < n; ++i) {
+			robots[i]->set_pos(csci3081::Position(x[i], y[i]));
+		}
+	}
+	Report("gather+kernel+scatter", std::chrono::steady_clock::now() - begin,
+	       n_moves);
+
+	for (auto r : robots) {
+		delete r;
+	}
+	return 0;
+}
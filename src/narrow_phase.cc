@@ -0,0 +1,138 @@
+/**
+ * @file narrow_phase.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/narrow_phase.h"
+
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define NARROW_PHASE_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define NARROW_PHASE_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Scalar kernel. The vector versions below perform exactly these
+ * operations, lane by lane, and use this for the candidates left over at the
+ * end of the block.
+ */
+static uint64_t CircleHitMaskScalar(double x, double y, double reach,
+                                    const double * cx, const double * cy,
+                                    const double * cr, size_t n) {
+	uint64_t mask = 0;
+	for (size_t k = 0; k < n; ++k) {
+		double dx = cx[k] - x;
+		double dy = cy[k] - y;
+		double r = cr[k] + reach;
+		if (dx * dx + dy * dy <= r * r) {
+			mask |= uint64_t(1) << k;
+		}
+	}
+	return mask;
+}
+
+#ifdef NARROW_PHASE_SSE2
+/**
+ * @brief SSE2 kernel, 2 candidates per iteration.
+ */
+static uint64_t CircleHitMaskSSE2(double x, double y, double reach,
+                                  const double * cx, const double * cy,
+                                  const double * cr, size_t n) {
+	const __m128d qx = _mm_set1_pd(x);
+	const __m128d qy = _mm_set1_pd(y);
+	const __m128d qr = _mm_set1_pd(reach);
+
+	uint64_t mask = 0;
+	size_t k = 0;
+	for (; k + 2 <= n; k += 2) {
+		__m128d dx = _mm_sub_pd(_mm_loadu_pd(cx + k), qx);
+		__m128d dy = _mm_sub_pd(_mm_loadu_pd(cy + k), qy);
+		__m128d r = _mm_add_pd(_mm_loadu_pd(cr + k), qr);
+		__m128d d2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+		uint64_t hits = _mm_movemask_pd(_mm_cmple_pd(d2, _mm_mul_pd(r, r)));
+		mask |= hits << k;
+	}
+	if (k < n) {
+		mask |= CircleHitMaskScalar(x, y, reach, cx + k, cy + k, cr + k, n - k) << k;
+	}
+	return mask;
+}
+#endif  // NARROW_PHASE_SSE2
+
+#ifdef NARROW_PHASE_AVX2
+/**
+ * @brief AVX2 kernel, 4 candidates per iteration. Only called once the CPU
+ * has been checked for AVX2.
+ */
+__attribute__((target("avx2")))
+static uint64_t CircleHitMaskAVX2(double x, double y, double reach,
+                                  const double * cx, const double * cy,
+                                  const double * cr, size_t n) {
+	const __m256d qx = _mm256_set1_pd(x);
+	const __m256d qy = _mm256_set1_pd(y);
+	const __m256d qr = _mm256_set1_pd(reach);
+
+	uint64_t mask = 0;
+	size_t k = 0;
+	for (; k + 4 <= n; k += 4) {
+		__m256d dx = _mm256_sub_pd(_mm256_loadu_pd(cx + k), qx);
+		__m256d dy = _mm256_sub_pd(_mm256_loadu_pd(cy + k), qy);
+		__m256d r = _mm256_add_pd(_mm256_loadu_pd(cr + k), qr);
+		__m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+		uint64_t hits = _mm256_movemask_pd(
+			_mm256_cmp_pd(d2, _mm256_mul_pd(r, r), _CMP_LE_OQ));
+		mask |= hits << k;
+	}
+	if (k < n) {
+		mask |= CircleHitMaskScalar(x, y, reach, cx + k, cy + k, cr + k, n - k) << k;
+	}
+	return mask;
+}
+#endif  // NARROW_PHASE_AVX2
+
+/**
+ * @brief Test one query circle against a block of candidate circles, using
+ * the fastest instruction set available.
+ */
+uint64_t CircleHitMask(double x, double y, double reach, const double * cx,
+                       const double * cy, const double * cr, size_t n) {
+	return CircleHitMask(KinematicsBestIsa(), x, y, reach, cx, cy, cr, n);
+}
+
+/**
+ * @brief Test one query circle against a block of candidate circles, using a
+ * specific instruction set.
+ */
+uint64_t CircleHitMask(enum kinematics_isa isa, double x, double y,
+                       double reach, const double * cx, const double * cy,
+                       const double * cr, size_t n) {
+	switch (isa) {
+#ifdef NARROW_PHASE_AVX2
+	case kKinematicsAVX2:
+		return CircleHitMaskAVX2(x, y, reach, cx, cy, cr, n);
+#endif
+#ifdef NARROW_PHASE_SSE2
+	case kKinematicsSSE2:
+		return CircleHitMaskSSE2(x, y, reach, cx, cy, cr, n);
+#endif
+	default:
+		return CircleHitMaskScalar(x, y, reach, cx, cy, cr, n);
+	}
+}
+
+NAMESPACE_END(csci3081);
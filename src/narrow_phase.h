@@ -0,0 +1,65 @@
+/**
+ * @file narrow_phase.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_NARROW_PHASE_H_
+#define SRC_NARROW_PHASE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+#include <cstddef>
+#include "src/common.h"
+#include "src/kinematics.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/**
+ * @brief Most candidates \ref CircleHitMask() tests at once, one per bit of
+ * the mask.
+ */
+static const size_t kCircleBlock = 64;
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Test one query circle against a block of candidate circles.
+ *
+ * Candidate k is hit if its center is within reach + cr[k] of the query
+ * point, compared as squared distances so there is no square root. Every
+ * instruction set does the same operations in the same order, so the mask is
+ * the same no matter which one the CPU picks.
+ *
+ * @param x The x coordinate of the query point
+ * @param y The y coordinate of the query point
+ * @param reach Radius of the query circle, plus any extra distance of interest
+ * @param cx The x coordinate of each candidate
+ * @param cy The y coordinate of each candidate
+ * @param cr Radius of each candidate
+ * @param n Number of candidates (at most \ref kCircleBlock)
+ * @return uint64_t Bit k set if candidate k is hit
+ */
+uint64_t CircleHitMask(double x, double y, double reach, const double * cx,
+                       const double * cy, const double * cr, size_t n);
+
+/**
+ * @brief \ref CircleHitMask() using a specific instruction set, which must be
+ * supported by the CPU (see \ref KinematicsIsaSupported()).
+ */
+uint64_t CircleHitMask(enum kinematics_isa isa, double x, double y,
+                       double reach, const double * cx, const double * cy,
+                       const double * cr, size_t n);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_NARROW_PHASE_H_
@@ -14,11 +14,6 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
-/*******************************************************************************
- * Static Variables
- ******************************************************************************/
-uint Obstacle::next_id_ = 0;
-
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -30,8 +25,8 @@ uint Obstacle::next_id_ = 0;
  */
 Obstacle::Obstacle(double radius, const Position& pos,
                    const csci3081::Color& color) :
-	ArenaImmobileEntity(radius, pos, color), id_(-1) {
-	id_ = next_id_++;
+	ArenaImmobileEntity(radius, pos, color) {
+	set_type(kObstacle);
 }
 
 NAMESPACE_END(csci3081);
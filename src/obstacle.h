@@ -40,12 +40,8 @@ public:
 	 * @return String The string "Obstacle" + id
 	 */
 	std::string get_name(void) const override {
-		return "Obstacle" + std::to_string(id_);
+		return "Obstacle" + std::to_string(get_id());
 	}
-
-private:
-	static uint next_id_; // id of next obstacle
-	int id_; // id of obstacle
 };
 
 NAMESPACE_END(csci3081);
@@ -0,0 +1,175 @@
+/**
+ * @file obstacle_tree.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include "src/obstacle_tree.h"
+#include "src/narrow_phase.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+/**
+ * @brief ObstacleTree constructor
+ */
+ObstacleTree::ObstacleTree(void) :
+	nodes_(), slots_(), x_(), y_(), radius_() {
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+/**
+ * @brief Build the tree over a set of circles.
+ * @param x The x coordinate of each circle, by slot
+ * @param y The y coordinate of each circle, by slot
+ * @param radius Radius of each circle, by slot
+ * @param slots Slots of the circles to build the tree over
+ * @param n Number of circles
+ */
+void ObstacleTree::Build(const double * x, const double * y,
+                         const double * radius, const unsigned int * slots,
+                         size_t n) {
+	nodes_.clear();
+	slots_.assign(slots, slots + n);
+	x_.resize(n);
+	y_.resize(n);
+	radius_.resize(n);
+	for (size_t k = 0; k < n; ++k) {
+		x_[k] = x[slots[k]];
+		y_[k] = y[slots[k]];
+		radius_[k] = radius[slots[k]];
+	}
+	if (n == 0) {
+		return;
+	}
+
+	std::vector<unsigned int> order(n);
+	for (size_t k = 0; k < n; ++k) {
+		order[k] = k;
+	}
+	BuildNode(&order, 0, n);
+
+	// Lay the circles out in the order the leaves refer to them
+	std::vector<unsigned int> slots_in_order(n);
+	std::vector<double> x_in_order(n), y_in_order(n), radius_in_order(n);
+	for (size_t k = 0; k < n; ++k) {
+		slots_in_order[k] = slots_[order[k]];
+		x_in_order[k] = x_[order[k]];
+		y_in_order[k] = y_[order[k]];
+		radius_in_order[k] = radius_[order[k]];
+	}
+	slots_.swap(slots_in_order);
+	x_.swap(x_in_order);
+	y_.swap(y_in_order);
+	radius_.swap(radius_in_order);
+}
+
+/**
+ * @brief Build the subtree over the circles [begin, end) of an ordering of
+ * them, reordering that range as it goes.
+ * @param order Indices of the circles, in the order they end up in
+ * @param begin First circle of the subtree in order
+ * @param end One past the last circle of the subtree in order
+ * @return unsigned int Index of the subtree's root in nodes_
+ */
+unsigned int ObstacleTree::BuildNode(std::vector<unsigned int> * order,
+                                     size_t begin, size_t end) {
+	unsigned int index = nodes_.size();
+	nodes_.push_back(node());
+
+	// Box around the circles, and around their centers to choose the split
+	node box;
+	box.min_x = box.min_y = 1e300;
+	box.max_x = box.max_y = -1e300;
+	double c_min_x = 1e300, c_min_y = 1e300, c_max_x = -1e300, c_max_y = -1e300;
+	for (size_t k = begin; k < end; ++k) {
+		unsigned int c = (*order)[k];
+		box.min_x = std::min(box.min_x, x_[c] - radius_[c]);
+		box.min_y = std::min(box.min_y, y_[c] - radius_[c]);
+		box.max_x = std::max(box.max_x, x_[c] + radius_[c]);
+		box.max_y = std::max(box.max_y, y_[c] + radius_[c]);
+		c_min_x = std::min(c_min_x, x_[c]);
+		c_min_y = std::min(c_min_y, y_[c]);
+		c_max_x = std::max(c_max_x, x_[c]);
+		c_max_y = std::max(c_max_y, y_[c]);
+	}
+
+	if (end - begin <= kLeafSize) {
+		box.first = begin;
+		box.count = end - begin;
+		nodes_[index] = box;
+		return index;
+	}
+
+	// Split in half along the longer side
+	size_t mid = begin + (end - begin) / 2;
+	const std::vector<double>& axis = c_max_x - c_min_x >= c_max_y - c_min_y ?
+		x_ : y_;
+	std::nth_element(order->begin() + begin, order->begin() + mid,
+	                 order->begin() + end,
+	                 [&axis](unsigned int a, unsigned int b) {
+		return axis[a] < axis[b] || (axis[a] == axis[b] && a < b);
+	});
+	BuildNode(order, begin, mid);
+	box.right = BuildNode(order, mid, end);
+	nodes_[index] = box;
+	return index;
+}
+
+/**
+ * @brief Find all circles within reach of a point.
+ * @param x The x coordinate of the query point
+ * @param y The y coordinate of the query point
+ * @param reach Largest distance from the point to the edge of a circle of
+ * interest
+ * @param out Filled with the slots of the circles within reach, in increasing
+ * order
+ */
+void ObstacleTree::Query(double x, double y, double reach,
+                         std::vector<unsigned int> * const out) const {
+	out->clear();
+	if (nodes_.empty()) {
+		return;
+	}
+
+	// The tree is balanced, so the stack never holds more than one node per
+	// level plus one
+	unsigned int stack[64];
+	size_t depth = 0;
+	stack[depth++] = 0;
+	while (depth > 0) {
+		unsigned int at = stack[--depth];
+		const node& nd = nodes_[at];
+		double dx = std::max(std::max(nd.min_x - x, x - nd.max_x), 0.0);
+		double dy = std::max(std::max(nd.min_y - y, y - nd.max_y), 0.0);
+		if (dx * dx + dy * dy > reach * reach) {
+			continue;
+		}
+		if (nd.count > 0) {
+			uint64_t mask = CircleHitMask(x, y, reach, &x_[nd.first], &y_[nd.first],
+			                              &radius_[nd.first], nd.count);
+			while (mask) {
+				out->push_back(slots_[nd.first + __builtin_ctzll(mask)]);
+				mask &= mask - 1;
+			}
+		}
+		else {
+			stack[depth++] = nd.right;
+			stack[depth++] = at + 1;
+		}
+	}
+	std::sort(out->begin(), out->end());
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,122 @@
+/**
+ * @file obstacle_tree.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_OBSTACLE_TREE_H_
+#define SRC_OBSTACLE_TREE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <vector>
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A bounding volume hierarchy over circles that never move, used to
+ * find the obstacles near a point in O(log N).
+ *
+ * \ref Build() is called once, with the obstacles' slots in the arrays passed
+ * to it. Every node of the tree holds the box around its circles; the circles
+ * are split in half along the longer side of the box around their centers
+ * until at most \ref kLeafSize are left, which are kept next to each other so
+ * \ref Query() can test a whole leaf at once with \ref CircleHitMask().
+ *
+ * Obstacles are few but large, so keeping them out of the \ref SpatialHash
+ * also keeps its cells, and the area every query covers, sized for the
+ * entities that move.
+ */
+class ObstacleTree {
+public:
+	/**
+	 * @brief Most circles kept in a leaf.
+	 */
+	static const size_t kLeafSize = 4;
+
+	/**
+	 * @brief ObstacleTree constructor. The tree is empty until \ref Build() is
+	 * called.
+	 */
+	ObstacleTree(void);
+
+	/**
+	 * @brief Build the tree over a set of circles, replacing whatever was there
+	 * before.
+	 * @param x The x coordinate of each circle, by slot
+	 * @param y The y coordinate of each circle, by slot
+	 * @param radius Radius of each circle, by slot
+	 * @param slots Slots of the circles to build the tree over
+	 * @param n Number of circles
+	 */
+	void Build(const double * x, const double * y, const double * radius,
+	           const unsigned int * slots, size_t n);
+
+	/**
+	 * @brief Find all circles within reach of a point.
+	 * @param x The x coordinate of the query point
+	 * @param y The y coordinate of the query point
+	 * @param reach Largest distance from the point to the edge of a circle of
+	 * interest
+	 * @param out Filled with the slots of the circles within reach, in
+	 * increasing order
+	 */
+	void Query(double x, double y, double reach,
+	           std::vector<unsigned int> * const out) const;
+
+	/**
+	 * @brief Gets the number of circles in the tree
+	 * @return size_t Number of circles
+	 */
+	size_t size(void) const {
+		return slots_.size();
+	}
+
+private:
+	/**
+	 * @brief A node of the tree, and the box around all of its circles.
+	 */
+	struct node {
+		node(void) : min_x(0), min_y(0), max_x(0), max_y(0), first(0), count(0),
+			right(0) {
+		}
+
+		double min_x; // left edge of the box
+		double min_y; // top edge of the box
+		double max_x; // right edge of the box
+		double max_y; // bottom edge of the box
+		unsigned int first; // first of the leaf's circles
+		unsigned int count; // number of circles in the leaf (0 if not a leaf)
+		unsigned int right; // the second child (the first is the next node)
+	};
+
+	/**
+	 * @brief Build the subtree over the circles [begin, end) of an ordering of
+	 * them, reordering that range as it goes.
+	 * @param order Indices of the circles, in the order they end up in
+	 * @param begin First circle of the subtree in order
+	 * @param end One past the last circle of the subtree in order
+	 * @return unsigned int Index of the subtree's root in nodes_
+	 */
+	unsigned int BuildNode(std::vector<unsigned int> * order, size_t begin,
+	                       size_t end);
+
+	std::vector<node> nodes_; // the tree, each node followed by its first child
+	std::vector<unsigned int> slots_; // slot of each circle, in tree order
+	std::vector<double> x_; // x coordinate of each circle, in tree order
+	std::vector<double> y_; // y coordinate of each circle, in tree order
+	std::vector<double> radius_; // radius of each circle, in tree order
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_OBSTACLE_TREE_H_
@@ -15,11 +15,6 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
-/*******************************************************************************
- * Static Variables
- ******************************************************************************/
-uint Player::next_id_ = 0;
-
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -30,7 +25,6 @@ uint Player::next_id_ = 0;
 Player::Player(const struct player_params* const params) :
 	ArenaMobileEntity(params->radius, params->collision_delta,
 	                  params->pos, params->color),
-	id_(-1),
 	pause_time_(0),
 	heading_angle_(0),
 	angle_delta_(params->angle_delta),
@@ -38,9 +32,9 @@ Player::Player(const struct player_params* const params) :
 	motion_handler_(),
 	motion_behavior_(),
 	sensor_touch_() {
+	set_type(kPlayer);
 	motion_handler_.set_heading_angle(270);
 	motion_handler_.set_speed(5);
-	id_ = next_id_++;
 }
 
 
@@ -55,12 +49,28 @@ Player::Player(const struct player_params* const params) :
 void Player::TimestepUpdate(uint dt) {
 	Position old_pos = get_pos();
 
-	// Update heading and speed as indicated by touch sensor
-	motion_handler_.UpdateVelocity(sensor_touch_);
+	UpdateVelocity();
 
 	// Use velocity and position to update position
 	motion_behavior_.UpdatePosition(this, dt);
 
+	PositionUpdated(old_pos, dt);
+}
+
+/**
+ * @brief Update the player's heading and speed from its sensors.
+ */
+void Player::UpdateVelocity(void) {
+	// Update heading and speed as indicated by touch sensor
+	motion_handler_.UpdateVelocity(sensor_touch_);
+}
+
+/**
+ * @brief Deplete the player's battery after it has moved.
+ * @param old_pos Position of the player before it moved
+ * @param dt The # of timesteps the player moved for
+ */
+void Player::PositionUpdated(const Position& old_pos, uint dt) {
 	// Deplete battery as appropriate given distance and speed of movement
 	battery_.Deplete(old_pos, get_pos(), dt);
 }
@@ -111,6 +121,31 @@ void Player::Reset(void) {
 	set_pos(pos);
 }
 
+/**
+ * @brief Write the player's position, battery, pause time, actuators and
+ * touch sensor.
+ * @param out Where to write them
+ */
+void Player::SaveState(StateWriter * const out) const {
+	ArenaMobileEntity::SaveState(out);
+	out->Write(pause_time_);
+	battery_.SaveState(out);
+	motion_handler_.SaveState(out);
+	sensor_touch_.SaveState(out);
+}
+
+/**
+ * @brief Read back the state written by SaveState().
+ * @param in Where to read it from
+ */
+void Player::LoadState(StateReader * const in) {
+	ArenaMobileEntity::LoadState(in);
+	in->Read(&pause_time_);
+	battery_.LoadState(in);
+	motion_handler_.LoadState(in);
+	sensor_touch_.LoadState(in);
+}
+
 /**
  * @brief Reset the player's battery to full after an encounter with the
  * recharge station.
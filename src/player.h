@@ -60,6 +60,19 @@ public:
 	 */
 	void Reset(void) override;
 
+	/**
+	 * @brief Write the player's position, battery, pause time, actuators and
+	 * touch sensor.
+	 * @param out Where to write them
+	 */
+	void SaveState(StateWriter * const out) const override;
+
+	/**
+	 * @brief Read back the state written by \ref SaveState().
+	 * @param in Where to read it from
+	 */
+	void LoadState(StateReader * const in) override;
+
 	/**
 	 * @brief Update the player's position and velocity after the specified
 	 * duration has passed.
@@ -67,6 +80,18 @@ public:
 	 */
 	void TimestepUpdate(unsigned int dt) override;
 
+	/**
+	 * @brief Update the player's heading and speed from its sensors.
+	 */
+	void UpdateVelocity(void) override;
+
+	/**
+	 * @brief Deplete the player's battery after it has moved.
+	 * @param old_pos Position of the player before it moved
+	 * @param dt The # of timesteps the player moved for
+	 */
+	void PositionUpdated(const Position& old_pos, unsigned int dt) override;
+
 	/**
 	 * @brief Accept a recharge event.
 	 * This causes the player's battery to become fully charged.
@@ -182,9 +207,6 @@ public:
 	}
 
 private:
-	static unsigned int next_id_; // id of next player added
-
-	int id_; // id of player
 	int pause_time_; // pause time for when superbot collides with player
 	double heading_angle_; // current direction of travel for player
 	double angle_delta_; // change in angle of player since last update
@@ -12,6 +12,7 @@
  ******************************************************************************/
 #include "src/common.h"
 #include "src/event_collision.h"
+#include "src/state_stream.h"
 
 /*******************************************************************************
  * Namespaces
@@ -69,6 +70,22 @@ public:
 		charge_ = max_charge_;
 	}
 
+	/**
+	 * @brief Write the battery's charge.
+	 * @param out Where to write it
+	 */
+	void SaveState(StateWriter * const out) const {
+		out->Write(charge_);
+	}
+
+	/**
+	 * @brief Read back a charge written by \ref SaveState().
+	 * @param in Where to read it from
+	 */
+	void LoadState(StateReader * const in) {
+		in->Read(&charge_);
+	}
+
 	/**
 	 * @brief Calculate the new battery level based on the distance travelled
 	 * @param old_pos Entities Position at last simulation update
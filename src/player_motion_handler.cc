@@ -7,6 +7,8 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <assert.h>
+#include <iostream>
 #include "src/player_motion_handler.h"
 
 /*******************************************************************************
@@ -85,4 +87,22 @@ void MotionHandlerPlayer::Reset() {
 	speed_ = 5;
 }
 
+/**
+ * @brief Write the heading and speed the player is commanded to.
+ * @param out Where to write them
+ */
+void MotionHandlerPlayer::SaveState(StateWriter * const out) const {
+	out->Write(heading_angle_);
+	out->Write(speed_);
+}
+
+/**
+ * @brief Read back a heading and speed written by \ref SaveState().
+ * @param in Where to read them from
+ */
+void MotionHandlerPlayer::LoadState(StateReader * const in) {
+	in->Read(&heading_angle_);
+	in->Read(&speed_);
+}
+
 NAMESPACE_END(csci3081);
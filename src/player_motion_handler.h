@@ -17,6 +17,7 @@
 #include "src/sensor_touch.h"
 #include "src/sensor_proximity.h"
 #include "src/motion_handler.h"
+#include "src/state_stream.h"
 
 /*******************************************************************************
  * Namespaces
@@ -53,6 +54,18 @@ public:
 	 */
 	void Reset(void);
 
+	/**
+	 * @brief Write the heading and speed the player is commanded to.
+	 * @param out Where to write them
+	 */
+	void SaveState(StateWriter * const out) const;
+
+	/**
+	 * @brief Read back a heading and speed written by \ref SaveState().
+	 * @param in Where to read them from
+	 */
+	void LoadState(StateReader * const in);
+
 	/**
 	 * @brief Command from user keypress via the viewer.
 	 * @param cmd The command.
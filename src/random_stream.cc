@@ -0,0 +1,94 @@
+/**
+ * @file random_stream.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/random_stream.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+// Polynomial that advances the generator by 2^128 steps
+static const uint64_t kJump[] = {
+	0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+	0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+};
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+/**
+ * @brief RandomStream constructor
+ * @param seed Any value; equal seeds give equal streams
+ */
+RandomStream::RandomStream(uint64_t seed) : s_() {
+	Seed(seed);
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+/**
+ * @brief Restart the stream from a seed.
+ * @param seed Any value; equal seeds give equal streams
+ */
+void RandomStream::Seed(uint64_t seed) {
+	// Spread the seed over the whole state with splitmix64, which never
+	// produces an all zero state
+	for (int i = 0; i < 4; ++i) {
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		s_[i] = z ^ (z >> 31);
+	}
+}
+
+/**
+ * @brief Skip 2^128 numbers ahead in the stream.
+ */
+void RandomStream::Jump(void) {
+	uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	for (int i = 0; i < 4; ++i) {
+		for (int b = 0; b < 64; ++b) {
+			if (kJump[i] & (1ULL << b)) {
+				s0 ^= s_[0];
+				s1 ^= s_[1];
+				s2 ^= s_[2];
+				s3 ^= s_[3];
+			}
+			Next();
+		}
+	}
+	s_[0] = s0;
+	s_[1] = s1;
+	s_[2] = s2;
+	s_[3] = s3;
+}
+
+/**
+ * @brief Write the generator state, so the stream can be picked up again from
+ * this point.
+ * @param out Where to write it
+ */
+void RandomStream::SaveState(StateWriter * const out) const {
+	out->Write(s_);
+}
+
+/**
+ * @brief Pick the stream up from a state written by SaveState().
+ * @param in Where to read it from
+ */
+void RandomStream::LoadState(StateReader * const in) {
+	in->Read(&s_);
+}
+
+NAMESPACE_END(csci3081);
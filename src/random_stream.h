@@ -0,0 +1,105 @@
+/**
+ * @file random_stream.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_RANDOM_STREAM_H_
+#define SRC_RANDOM_STREAM_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdint.h>
+#include "src/common.h"
+#include "src/state_stream.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A small, fast pseudo-random number generator (xoshiro256**) whose
+ * whole state lives in the object.
+ *
+ * Each \ref Arena owns one, so arenas never contend on (or perturb) each other's
+ * randomness, and a game replays exactly from its seed. \ref Jump() skips
+ * 2^128 numbers ahead, which splits one seed into many streams that will never
+ * overlap, e.g. one per game of an ensemble.
+ */
+class RandomStream {
+public:
+	/**
+	 * @brief RandomStream constructor
+	 * @param seed Any value; equal seeds give equal streams
+	 */
+	explicit RandomStream(uint64_t seed = 0);
+
+	RandomStream(const RandomStream& other) = default;
+	RandomStream& operator=(const RandomStream& other) = default;
+
+	/**
+	 * @brief Restart the stream from a seed.
+	 * @param seed Any value; equal seeds give equal streams
+	 */
+	void Seed(uint64_t seed);
+
+	/**
+	 * @brief Skip 2^128 numbers ahead in the stream.
+	 */
+	void Jump(void);
+
+	/**
+	 * @brief Write the generator state, so the stream can be picked up again
+	 * from this point.
+	 * @param out Where to write it
+	 */
+	void SaveState(StateWriter * const out) const;
+
+	/**
+	 * @brief Pick the stream up from a state written by \ref SaveState().
+	 * @param in Where to read it from
+	 */
+	void LoadState(StateReader * const in);
+
+	/**
+	 * @brief Get the next 64 random bits.
+	 */
+	uint64_t Next(void) {
+		uint64_t result = Rotl(s_[1] * 5, 7) * 9;
+		uint64_t t = s_[1] << 17;
+		s_[2] ^= s_[0];
+		s_[3] ^= s_[1];
+		s_[1] ^= s_[2];
+		s_[0] ^= s_[3];
+		s_[2] ^= t;
+		s_[3] = Rotl(s_[3], 45);
+		return result;
+	}
+
+	/**
+	 * @brief Get a random integer in [0, n).
+	 * @param n Number of possible values (at least 1)
+	 */
+	unsigned int Uniform(unsigned int n) {
+		return ((Next() >> 32) * n) >> 32;
+	}
+
+private:
+	/**
+	 * @brief Rotate the bits of x left by k.
+	 */
+	static uint64_t Rotl(uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+
+	uint64_t s_[4]; // generator state, never all zero
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_RANDOM_STREAM_H_
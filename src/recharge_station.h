@@ -36,6 +36,7 @@ public:
 	RechargeStation(double radius, const Position& pos,
 	                const csci3081::Color& color) :
 		Obstacle(radius, pos, color) {
+		set_type(kRechargeStation);
 	}
 
 	/**
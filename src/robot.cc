@@ -15,11 +15,6 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
-/*******************************************************************************
- * Static Variables
- ******************************************************************************/
-uint Robot::next_id_ = 0;
-
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -32,7 +27,6 @@ Robot::Robot(const struct robot_params* const params) :
 	                  params->pos, params->color),
 	frozen_(0),
 	super_(0),
-	id_(-1),
 	heading_angle_(0),
 	angle_delta_(params->angle_delta),
 	starting_pos_(params->starting_pos),
@@ -44,9 +38,9 @@ Robot::Robot(const struct robot_params* const params) :
 	sensor_proximity_2_(),
 	sensor_distress_(),
 	sensor_entity_type_() {
+	set_type(kRobot);
 	motion_handler_.set_heading_angle(270);
 	motion_handler_.set_speed(5);
-	id_ = next_id_++;
 }
 
 /**
@@ -65,14 +59,38 @@ Robot::~Robot(void) {
  * @param dt The # of timesteps that have elapsed since the last update.
  */
 void Robot::TimestepUpdate(uint dt) {
-	// Update heading and speed as indicated by touch sensor
-	motion_handler_.UpdateVelocity(sensor_touch_);
+	Position old_pos = get_pos();
 
-	motion_handler_.UpdateVelocity(sensor_proximity_1_);
+	UpdateVelocity();
 
 	// Use velocity and position to update position
 	motion_behavior_.UpdatePosition(this, dt);
 
+	PositionUpdated(old_pos, dt);
+}
+
+/**
+ * @brief Update the robot's heading and speed from its sensors. A frozen robot
+ * keeps its heading until it is unfrozen.
+ */
+void Robot::UpdateVelocity(void) {
+	if (frozen_) {
+		return;
+	}
+
+	// Update heading and speed as indicated by touch sensor
+	motion_handler_.UpdateVelocity(sensor_touch_);
+
+	motion_handler_.UpdateVelocity(sensor_proximity_1_);
+}
+
+/**
+ * @brief Remember where the robot moved to.
+ * @param old_pos Position of the robot before it moved
+ * @param dt The # of timesteps the robot moved for
+ */
+void Robot::PositionUpdated(__unused const Position& old_pos,
+                         __unused uint dt) {
 	old_pos_ = get_pos();
 }
 
@@ -133,4 +151,38 @@ void Robot::Reset(void) {
 	set_pos(pos);
 }
 
+/**
+ * @brief Write the robot's position, frozen and super flags, actuators and sensors.
+ * @param out Where to write them
+ */
+void Robot::SaveState(StateWriter * const out) const {
+	ArenaMobileEntity::SaveState(out);
+	out->Write(frozen_);
+	out->Write(super_);
+	out->Write(old_pos_);
+	motion_handler_.SaveState(out);
+	sensor_touch_.SaveState(out);
+	sensor_proximity_1_.SaveState(out);
+	sensor_proximity_2_.SaveState(out);
+	sensor_distress_.SaveState(out);
+	sensor_entity_type_.SaveState(out);
+}
+
+/**
+ * @brief Read back the state written by SaveState().
+ * @param in Where to read it from
+ */
+void Robot::LoadState(StateReader * const in) {
+	ArenaMobileEntity::LoadState(in);
+	in->Read(&frozen_);
+	in->Read(&super_);
+	in->Read(&old_pos_);
+	motion_handler_.LoadState(in);
+	sensor_touch_.LoadState(in);
+	sensor_proximity_1_.LoadState(in);
+	sensor_proximity_2_.LoadState(in);
+	sensor_distress_.LoadState(in);
+	sensor_entity_type_.LoadState(in);
+}
+
 NAMESPACE_END(csci3081);
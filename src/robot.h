@@ -59,6 +59,19 @@ public:
 	 */
 	void Reset(void) override;
 
+	/**
+	 * @brief Write the robot's position, frozen and super flags, actuators and
+	 * sensors.
+	 * @param out Where to write them
+	 */
+	void SaveState(StateWriter * const out) const override;
+
+	/**
+	 * @brief Read back the state written by \ref SaveState().
+	 * @param in Where to read it from
+	 */
+	void LoadState(StateReader * const in) override;
+
 	/**
 	 * @brief Update the robot's position and velocity after the specified
 	 * duration has passed.
@@ -66,6 +79,19 @@ public:
 	 */
 	void TimestepUpdate(unsigned int dt) override;
 
+	/**
+	 * @brief Update the robot's heading and speed from its sensors. A frozen
+	 * robot keeps its heading until it is unfrozen.
+	 */
+	void UpdateVelocity(void) override;
+
+	/**
+	 * @brief Remember where the robot moved to.
+	 * @param old_pos Position of the robot before it moved
+	 * @param dt The # of timesteps the robot moved for
+	 */
+	void PositionUpdated(const Position& old_pos, unsigned int dt) override;
+
 	/**
 	 * @brief  Pass along a collision event (from arena) to the touch sensor.
 	 * This method provides a framework in which sensors can get different types
@@ -184,10 +210,8 @@ public:
 	}
 
 private:
-	static unsigned int next_id_; // id of the next robot in system
 	int frozen_; // boolean to show whether robot is frozen or not
 	int super_; // boolean to show if robot has been collided with by home base
-	int id_; // id of this robot
 	double heading_angle_; // angle in degrees the robot is travelling
 	double angle_delta_; // change in heading anlge of robot since last update
 	Position starting_pos_; // starting position of robot
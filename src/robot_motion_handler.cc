@@ -65,4 +65,22 @@ void MotionHandlerRobot::Reset() {
 	speed_ = 5;
 }
 
+/**
+ * @brief Write the heading and speed the robot is commanded to.
+ * @param out Where to write them
+ */
+void MotionHandlerRobot::SaveState(StateWriter * const out) const {
+	out->Write(heading_angle_);
+	out->Write(speed_);
+}
+
+/**
+ * @brief Read back a heading and speed written by \ref SaveState().
+ * @param in Where to read them from
+ */
+void MotionHandlerRobot::LoadState(StateReader * const in) {
+	in->Read(&heading_angle_);
+	in->Read(&speed_);
+}
+
 NAMESPACE_END(csci3081);
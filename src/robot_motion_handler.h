@@ -16,6 +16,7 @@
 #include "src/sensor_touch.h"
 #include "src/sensor_proximity.h"
 #include "src/motion_handler.h"
+#include "src/state_stream.h"
 
 /*******************************************************************************
  * Namespaces
@@ -52,6 +53,18 @@ public:
 	 */
 	void Reset(void);
 
+	/**
+	 * @brief Write the heading and speed the robot is commanded to.
+	 * @param out Where to write them
+	 */
+	void SaveState(StateWriter * const out) const;
+
+	/**
+	 * @brief Read back a heading and speed written by \ref SaveState().
+	 * @param in Where to read them from
+	 */
+	void LoadState(StateReader * const in);
+
 	/**
 	 * @brief Change the speed and direction according to the sensor readings.
 	 * @param st Touch sensor that can be activated and contains point-of-contact.
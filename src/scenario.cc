@@ -0,0 +1,570 @@
+/**
+ * @file scenario.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <assert.h>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/scenario.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+// First bytes of every binary scenario, and the version of its layout
+static const uint32_t kScenarioMagic = 0x43534152; // "RASC"
+static const uint32_t kScenarioVersion = 1;
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief The start of a binary scenario. It is followed by the records of the
+ * player, the recharge station, the home base, then the obstacles, the robots
+ * and the superbots.
+ */
+struct scenario_header {
+	uint32_t magic; // kScenarioMagic
+	uint32_t version; // kScenarioVersion
+	uint32_t x_dim; // number of pixels wide the arena is
+	uint32_t y_dim; // number of pixels tall the arena is
+	uint64_t seed; // seed of the arena's random numbers
+	uint32_t timestep; // # of timesteps each tick covers
+	uint32_t n_obstacles; // number of obstacle records
+	uint32_t n_robots; // number of robot records
+	uint32_t n_superbots; // number of superbot records
+};
+
+/**
+ * @brief One entity of a binary scenario. Every kind of entity takes a whole
+ * record, so they can be found by index; the fields a kind doesn't have are 0.
+ */
+struct scenario_record {
+	double radius; // radius of the entity in pixels
+	double collision_delta; // distance that counts as a collision
+	double battery_max_charge; // max battery level of a player
+	int32_t x; // where the entity is placed
+	int32_t y;
+	int32_t start_x; // where a robot starts from
+	int32_t start_y;
+	int32_t color[4]; // red, green, blue and alpha
+	uint32_t angle_delta; // change in heading angle per turn
+	uint32_t own_angle_delta; // a superbot's own angle delta
+	int32_t own_start_x; // where a superbot starts from
+	int32_t own_start_y;
+};
+
+static_assert(sizeof(scenario_header) == 40 && sizeof(scenario_record) == 72,
+              "binary scenarios are laid out without padding");
+
+/**
+ * @brief Reads the numbers of a line of a text scenario, one after another.
+ */
+struct line_reader {
+	explicit line_reader(const char * text) : at(text), ok(true) {
+	}
+
+	line_reader(const line_reader& other) = delete;
+	line_reader& operator=(const line_reader& other) = delete;
+
+	/**
+	 * @brief Read the next number, which must be a whole number in [lo, hi].
+	 */
+	long long Int(long long lo, long long hi) {
+		char * end;
+		long long v = strtoll(at, &end, 10);
+		ok = ok && end != at && v >= lo && v <= hi;
+		at = end;
+		return v;
+	}
+
+	/**
+	 * @brief Read the next number, which must be a whole number that fits in
+	 * 64 bits unsigned.
+	 */
+	uint64_t Uint64(void) {
+		char * end;
+		at += strspn(at, " \t\r");
+		uint64_t v = strtoull(at, &end, 10);
+		ok = ok && end != at && *at != '-';
+		at = end;
+		return v;
+	}
+
+	/**
+	 * @brief Read the next number.
+	 */
+	double Real(void) {
+		char * end;
+		double v = strtod(at, &end);
+		ok = ok && end != at;
+		at = end;
+		return v;
+	}
+
+	/**
+	 * @brief Whether every number was read and nothing is left on the line.
+	 */
+	bool Done(void) {
+		at += strspn(at, " \t\r");
+		return ok && *at == '\0';
+	}
+
+	const char * at; // next character to read
+	bool ok; // whether every number so far was read
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Read the fields every entity has: position, radius and color.
+ */
+static void ReadEntity(line_reader * const in,
+                       struct arena_entity_params * const params) {
+	int x = in->Int(INT_MIN, INT_MAX);
+	int y = in->Int(INT_MIN, INT_MAX);
+	params->pos = Position(x, y);
+	params->radius = in->Real();
+	int r = in->Int(0, 255);
+	int g = in->Int(0, 255);
+	int b = in->Int(0, 255);
+	int a = in->Int(0, 255);
+	params->color = Color(r, g, b, a);
+}
+
+/**
+ * @brief Read the fields every entity has, then a collision delta and an
+ * angle delta.
+ * @return unsigned int The angle delta
+ */
+static unsigned int ReadMobile(line_reader * const in,
+                               struct arena_mobile_entity_params * const params) {
+	ReadEntity(in, params);
+	params->collision_delta = in->Real();
+	return in->Int(0, UINT_MAX);
+}
+
+/**
+ * @brief Read the entities and settings of a text scenario.
+ * @param text The mapped file
+ * @param size Size of the file in bytes
+ * @param path Path of the file, for error messages
+ * @param params Set to the parameters read
+ * @return bool Whether it holds a whole scenario
+ */
+static bool ParseText(const char * text, size_t size, const char * path,
+                      struct arena_params * const params) {
+	bool have_arena = false, have_player = false, have_recharge = false,
+		have_home_base = false;
+	std::string line;
+	size_t line_no = 0;
+	for (const char * begin = text; begin < text + size;) {
+		const char * end = static_cast<const char*>(
+			memchr(begin, '\n', text + size - begin));
+		if (!end) {
+			end = text + size;
+		}
+		line.assign(begin, end);
+		begin = end + 1;
+		++line_no;
+		size_t comment = line.find('#');
+		if (comment != std::string::npos) {
+			line.resize(comment);
+		}
+
+		char keyword[32];
+		int keyword_len = 0;
+		if (sscanf(line.c_str(), " %31s%n", keyword, &keyword_len) != 1) {
+			continue;  // nothing on the line
+		}
+		line_reader in(line.c_str() + keyword_len);
+		if (!strcmp(keyword, "arena")) {
+			params->x_dim = in.Int(1, UINT_MAX);
+			params->y_dim = in.Int(1, UINT_MAX);
+			have_arena = true;
+		}
+		else if (!strcmp(keyword, "seed")) {
+			params->seed = in.Uint64();
+		}
+		else if (!strcmp(keyword, "timestep")) {
+			params->timestep = in.Int(1, UINT_MAX);
+		}
+		else if (!strcmp(keyword, "player")) {
+			params->player.angle_delta = ReadMobile(&in, &params->player);
+			params->player.battery_max_charge = in.Real();
+			have_player = true;
+		}
+		else if (!strcmp(keyword, "recharge_station")) {
+			ReadEntity(&in, &params->recharge_station);
+			have_recharge = true;
+		}
+		else if (!strcmp(keyword, "home_base")) {
+			params->home_base.angle_delta = ReadMobile(&in, &params->home_base);
+			have_home_base = true;
+		}
+		else if (!strcmp(keyword, "obstacle")) {
+			params->obstacles.push_back(arena_entity_params());
+			ReadEntity(&in, &params->obstacles.back());
+		}
+		else if (!strcmp(keyword, "robot")) {
+			params->robots.push_back(robot_params());
+			robot_params& r = params->robots.back();
+			r.angle_delta = ReadMobile(&in, &r);
+			r.starting_pos = r.pos;
+		}
+		else if (!strcmp(keyword, "superbot")) {
+			params->superbots.push_back(superbot_params());
+			superbot_params& s = params->superbots.back();
+			s.robot_params::angle_delta = ReadMobile(&in, &s);
+			s.robot_params::starting_pos = s.pos;
+			s.superbot_params::angle_delta = s.robot_params::angle_delta;
+			s.superbot_params::starting_pos = s.pos;
+		}
+		else {
+			fprintf(stderr, "%s:%zu: unknown entry '%s'\n", path, line_no, keyword);
+			return false;
+		}
+		if (!in.Done()) {
+			fprintf(stderr, "%s:%zu: wrong number or kind of values for '%s'\n",
+			        path, line_no, keyword);
+			return false;
+		}
+	}
+
+	if (!have_arena || !have_player || !have_recharge || !have_home_base) {
+		fprintf(stderr, "%s: needs an arena, player, recharge_station and "
+		        "home_base line\n", path);
+		return false;
+	}
+	if (params->superbots.size() < params->robots.size()) {
+		if (params->superbots.empty()) {
+			fprintf(stderr, "%s: needs a superbot line for the robots\n", path);
+			return false;
+		}
+		params->superbots.resize(params->robots.size(), params->superbots.back());
+	}
+	return true;
+}
+
+/**
+ * @brief Fill in the fields every entity has from a record.
+ */
+static void FromRecord(const struct scenario_record& rec,
+                       struct arena_entity_params * const params) {
+	params->radius = rec.radius;
+	params->pos = Position(rec.x, rec.y);
+	params->color = Color(rec.color[0], rec.color[1], rec.color[2], rec.color[3]);
+}
+
+/**
+ * @brief Fill in the parameters of a player (or home base) from a record.
+ */
+static void FromRecord(const struct scenario_record& rec,
+                       struct player_params * const params) {
+	FromRecord(rec, static_cast<arena_entity_params*>(params));
+	params->collision_delta = rec.collision_delta;
+	params->battery_max_charge = rec.battery_max_charge;
+	params->angle_delta = rec.angle_delta;
+}
+
+/**
+ * @brief Fill in the parameters of a robot from a record.
+ */
+static void FromRecord(const struct scenario_record& rec,
+                       struct robot_params * const params) {
+	FromRecord(rec, static_cast<arena_entity_params*>(params));
+	params->collision_delta = rec.collision_delta;
+	params->angle_delta = rec.angle_delta;
+	params->starting_pos = Position(rec.start_x, rec.start_y);
+}
+
+/**
+ * @brief Fill in the parameters of a superbot from a record.
+ */
+static void FromRecord(const struct scenario_record& rec,
+                       struct superbot_params * const params) {
+	FromRecord(rec, static_cast<robot_params*>(params));
+	params->superbot_params::angle_delta = rec.own_angle_delta;
+	params->superbot_params::starting_pos =
+		Position(rec.own_start_x, rec.own_start_y);
+}
+
+/**
+ * @brief Make the record of an entity, with the fields every entity has.
+ */
+static struct scenario_record ToRecord(
+	const struct arena_entity_params& params) {
+	struct scenario_record rec;
+	memset(&rec, 0, sizeof(rec));
+	rec.radius = params.radius;
+	rec.x = params.pos.x();
+	rec.y = params.pos.y();
+	rec.color[0] = params.color.r;
+	rec.color[1] = params.color.g;
+	rec.color[2] = params.color.b;
+	rec.color[3] = params.color.a;
+	return rec;
+}
+
+/**
+ * @brief Make the record of a player (or home base).
+ */
+static struct scenario_record ToRecord(const struct player_params& params) {
+	struct scenario_record rec =
+		ToRecord(static_cast<const arena_entity_params&>(params));
+	rec.collision_delta = params.collision_delta;
+	rec.battery_max_charge = params.battery_max_charge;
+	rec.angle_delta = params.angle_delta;
+	return rec;
+}
+
+/**
+ * @brief Make the record of a robot.
+ */
+static struct scenario_record ToRecord(const struct robot_params& params) {
+	struct scenario_record rec =
+		ToRecord(static_cast<const arena_entity_params&>(params));
+	rec.collision_delta = params.collision_delta;
+	rec.angle_delta = params.angle_delta;
+	rec.start_x = params.starting_pos.x();
+	rec.start_y = params.starting_pos.y();
+	return rec;
+}
+
+/**
+ * @brief Make the record of a superbot.
+ */
+static struct scenario_record ToRecord(const struct superbot_params& params) {
+	struct scenario_record rec =
+		ToRecord(static_cast<const robot_params&>(params));
+	rec.own_angle_delta = params.superbot_params::angle_delta;
+	rec.own_start_x = params.superbot_params::starting_pos.x();
+	rec.own_start_y = params.superbot_params::starting_pos.y();
+	return rec;
+}
+
+/**
+ * @brief Read the entities and settings of a binary scenario.
+ * @param data The mapped file
+ * @param size Size of the file in bytes
+ * @param path Path of the file, for error messages
+ * @param params Set to the parameters read
+ * @return bool Whether it holds a whole scenario
+ */
+static bool ParseBinary(const uint8_t * data, size_t size, const char * path,
+                        struct arena_params * const params) {
+	struct scenario_header header;
+	memcpy(&header, data, sizeof(header));
+	uint64_t n_records = 3 + uint64_t(header.n_obstacles) + header.n_robots +
+		header.n_superbots;
+	if (header.version != kScenarioVersion ||
+	    size != sizeof(header) + n_records * sizeof(scenario_record) ||
+	    header.n_superbots < header.n_robots) {
+		fprintf(stderr, "%s: not a whole binary scenario of version %u\n", path,
+		        kScenarioVersion);
+		return false;
+	}
+	params->x_dim = header.x_dim;
+	params->y_dim = header.y_dim;
+	params->seed = header.seed;
+	params->timestep = header.timestep;
+
+	// The records are copied out one by one, since the mapping makes no
+	// promises about how they are aligned
+	const uint8_t * at = data + sizeof(header);
+	struct scenario_record rec;
+	auto next = [&at, &rec](void) -> const scenario_record& {
+		memcpy(&rec, at, sizeof(rec));
+		at += sizeof(rec);
+		return rec;
+	};
+	FromRecord(next(), &params->player);
+	FromRecord(next(), &params->recharge_station);
+	FromRecord(next(), &params->home_base);
+	params->obstacles.resize(header.n_obstacles);
+	for (auto& o : params->obstacles) {
+		FromRecord(next(), &o);
+	}
+	params->robots.resize(header.n_robots);
+	for (auto& r : params->robots) {
+		FromRecord(next(), &r);
+	}
+	params->superbots.resize(header.n_superbots);
+	for (auto& s : params->superbots) {
+		FromRecord(next(), &s);
+	}
+	return true;
+}
+
+/**
+ * @brief Read the arena_params of a game from a scenario file, in either form.
+ * @param path Path of the scenario file
+ * @param params Set to the parameters read
+ * @return bool Whether the file could be read and holds a whole scenario
+ */
+bool LoadScenario(const char * path, struct arena_params * const params) {
+	int fd = open(path, O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		if (fd >= 0) {
+			close(fd);
+		}
+		return false;
+	}
+	size_t size = st.st_size;
+	void * mapped = size > 0 ?
+		mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+	close(fd);
+	if (mapped == MAP_FAILED) {
+		fprintf(stderr, "%s: %s\n", path, strerror(errno));
+		return false;
+	}
+	const uint8_t * data = static_cast<const uint8_t*>(mapped);
+
+	struct arena_params read;
+	bool ok;
+	uint32_t magic = 0;
+	if (size >= sizeof(scenario_header)) {
+		memcpy(&magic, data, sizeof(magic));
+	}
+	if (magic == kScenarioMagic) {
+		ok = ParseBinary(data, size, path, &read);
+	}
+	else {
+		ok = ParseText(reinterpret_cast<const char*>(data), size, path, &read);
+	}
+	if (mapped) {
+		munmap(mapped, size);
+	}
+	if (ok) {
+		*params = std::move(read);
+	}
+	return ok;
+}
+
+/**
+ * @brief Write the fields every entity has as text.
+ */
+static void PrintEntity(FILE * f, const char * keyword,
+                        const struct arena_entity_params& params) {
+	fprintf(f, "%s %d %d %.17g %d %d %d %d", keyword,
+	        static_cast<int>(params.pos.x()), static_cast<int>(params.pos.y()),
+	        params.radius, params.color.r, params.color.g,
+	        params.color.b, params.color.a);
+}
+
+/**
+ * @brief Write an arena_params as a text scenario.
+ */
+static void PrintText(FILE * f, const struct arena_params& params) {
+	fprintf(f, "arena %u %u\nseed %llu\ntimestep %u\n", params.x_dim,
+	        params.y_dim, static_cast<unsigned long long>(params.seed),
+	        params.timestep);
+	PrintEntity(f, "player", params.player);
+	fprintf(f, " %.17g %u %.17g\n", params.player.collision_delta,
+	        params.player.angle_delta, params.player.battery_max_charge);
+	PrintEntity(f, "recharge_station", params.recharge_station);
+	fprintf(f, "\n");
+	PrintEntity(f, "home_base", params.home_base);
+	fprintf(f, " %.17g %u\n", params.home_base.collision_delta,
+	        params.home_base.angle_delta);
+	for (const auto& o : params.obstacles) {
+		PrintEntity(f, "obstacle", o);
+		fprintf(f, "\n");
+	}
+	for (const auto& r : params.robots) {
+		PrintEntity(f, "robot", r);
+		fprintf(f, " %.17g %u\n", r.collision_delta, r.angle_delta);
+	}
+	for (const auto& s : params.superbots) {
+		PrintEntity(f, "superbot", s);
+		fprintf(f, " %.17g %u\n", s.collision_delta,
+		        s.superbot_params::angle_delta);
+	}
+}
+
+/**
+ * @brief Write an arena_params as a binary scenario.
+ * @return bool Whether the whole file was written
+ */
+static bool WriteBinary(FILE * f, const struct arena_params& params) {
+	struct scenario_header header;
+	memset(&header, 0, sizeof(header));
+	header.magic = kScenarioMagic;
+	header.version = kScenarioVersion;
+	header.x_dim = params.x_dim;
+	header.y_dim = params.y_dim;
+	header.seed = params.seed;
+	header.timestep = params.timestep;
+	header.n_obstacles = params.obstacles.size();
+	header.n_robots = params.robots.size();
+	header.n_superbots = params.superbots.size();
+
+	std::vector<scenario_record> records;
+	records.reserve(3 + params.obstacles.size() + params.robots.size() +
+	                params.superbots.size());
+	records.push_back(ToRecord(params.player));
+	records.push_back(ToRecord(params.recharge_station));
+	records.push_back(ToRecord(params.home_base));
+	for (const auto& o : params.obstacles) {
+		records.push_back(ToRecord(o));
+	}
+	for (const auto& r : params.robots) {
+		records.push_back(ToRecord(r));
+	}
+	for (const auto& s : params.superbots) {
+		records.push_back(ToRecord(s));
+	}
+	return fwrite(&header, sizeof(header), 1, f) == 1 &&
+		fwrite(records.data(), sizeof(scenario_record), records.size(), f) ==
+		records.size();
+}
+
+/**
+ * @brief Write the arena_params of a game to a scenario file.
+ * @param path Path of the file, which is replaced if it exists
+ * @param params Parameters to write
+ * @param format Which form to write the file in
+ * @return bool Whether the whole file was written
+ */
+bool SaveScenario(const char * path, const struct arena_params& params,
+                  enum scenario_format format) {
+	assert(params.superbots.size() >= params.robots.size());
+	FILE * f = fopen(path, format == kScenarioBinary ? "wb" : "w");
+	if (!f) {
+		return false;
+	}
+	bool written = true;
+	if (format == kScenarioBinary) {
+		written = WriteBinary(f, params);
+	}
+	else {
+		PrintText(f, params);
+		written = !ferror(f);
+	}
+	return fclose(f) == 0 && written;
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,86 @@
+/**
+ * @file scenario.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_SCENARIO_H_
+#define SRC_SCENARIO_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/common.h"
+#include "src/arena_params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief The two forms a scenario file can take.
+ */
+enum scenario_format {
+	kScenarioText, // one line per entity, for people to read and write
+	kScenarioBinary, // packed fixed-size records, for large arenas
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Read the arena_params of a game from a scenario file, in either
+ * form; the form is told apart by the first bytes of the file.
+ *
+ * The text form has one entity or setting per line, with blank lines and
+ * anything after a '#' ignored:
+ *
+ *     arena <x_dim> <y_dim>
+ *     seed <seed>
+ *     timestep <timesteps per tick>
+ *     player <x> <y> <radius> <r> <g> <b> <a> <collision_delta> <angle_delta> <battery_max_charge>
+ *     recharge_station <x> <y> <radius> <r> <g> <b> <a>
+ *     home_base <x> <y> <radius> <r> <g> <b> <a> <collision_delta> <angle_delta>
+ *     obstacle <x> <y> <radius> <r> <g> <b> <a>
+ *     robot <x> <y> <radius> <r> <g> <b> <a> <collision_delta> <angle_delta>
+ *     superbot <x> <y> <radius> <r> <g> <b> <a> <collision_delta> <angle_delta>
+ *
+ * The arena, player, recharge station and home base lines must be there;
+ * seed and timestep default to 0 and 1. A robot starts where it is placed.
+ * The k-th superbot line is the superbot the k-th robot is promoted to; the
+ * robots after the last superbot line get copies of it.
+ *
+ * The binary form is a header followed by one fixed-size record per entity,
+ * in the machine's byte order, written by \ref SaveScenario(). It is mapped
+ * into memory and the records are copied straight into the arena_params, in
+ * one pass with nothing to parse, so it is the form to use for arenas with
+ * very many entities.
+ *
+ * @param path Path of the scenario file
+ * @param params Set to the parameters read; left as they were if the file
+ * can't be read
+ * @return bool Whether the file could be read and holds a whole scenario; if
+ * not, what is wrong with it is printed to stderr
+ */
+bool LoadScenario(const char * path, struct arena_params * const params);
+
+/**
+ * @brief Write the arena_params of a game to a scenario file that
+ * \ref LoadScenario() reads back.
+ * @param path Path of the file, which is replaced if it exists
+ * @param params Parameters to write; there must be a superbot for every robot
+ * @param format Which form to write the file in. The text form doesn't keep a
+ * robot's starting position apart from its position, or a superbot's own
+ * angle delta and starting position apart from its robot ones.
+ * @return bool Whether the whole file was written
+ */
+bool SaveScenario(const char * path, const struct arena_params& params,
+                  enum scenario_format format);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SCENARIO_H_
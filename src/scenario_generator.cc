@@ -0,0 +1,318 @@
+/**
+ * @file scenario_generator.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "src/scenario_generator.h"
+#include "src/default_arena_params.h"
+#include "src/random_stream.h"
+#include "src/spatial_hash.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+// Extra room around every entity: rounding positions to whole pixels can move
+// two entities up to sqrt(2) pixels closer together
+static const double kClearance = 2;
+
+// Room each entity has to move about in within its cells, as a fraction of
+// the largest radius a cell is sized for, so even the largest entities aren't
+// always at the middle of their cells
+static const double kJitter = 0.25;
+
+// Random free blocks tried for an obstacle before giving up on fitting it
+static const unsigned int kTriesPerBlock = 64;
+
+// Fewest robots CheckScenario() tells a lattice from random placement with:
+// random coordinates share a common step this often by chance less than once
+// in thousands of scenarios
+static const size_t kLatticeRobots = 16;
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief The grid of cells entities are placed in, and which cells are taken.
+ */
+struct placement_grid {
+	placement_grid(void) : cols(0), rows(0), cell(0), margin(0), taken() {
+	}
+
+	unsigned int cols; // number of cells across
+	unsigned int rows; // number of cells down
+	double cell; // width and height of a cell
+	double margin; // room between the walls and the grid
+	std::vector<uint8_t> taken; // whether each cell is taken, row by row
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Get the greatest common divisor of two whole numbers, 0 if both are
+ * 0.
+ */
+static long GreatestCommonDivisor(long a, long b) {
+	a = std::labs(a);
+	b = std::labs(b);
+	while (b != 0) {
+		long t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * @brief Get a random number in [0, 1).
+ */
+static double Uniform01(RandomStream * const rng) {
+	return (rng->Next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Place an entity at a random point of the b x b block of cells whose
+ * top left cell is given, keeping its footprint inside the block.
+ */
+static Position PlaceInBlock(const struct placement_grid& grid,
+                             RandomStream * const rng, unsigned int col,
+                             unsigned int row, unsigned int b,
+                             double footprint) {
+	double slack = b * grid.cell - 2 * footprint;
+	double x = grid.margin + col * grid.cell + footprint + slack * Uniform01(rng);
+	double y = grid.margin + row * grid.cell + footprint + slack * Uniform01(rng);
+	return Position(std::lround(x), std::lround(y));
+}
+
+/**
+ * @brief Place an entity in a random free block of cells big enough for it,
+ * and take those cells.
+ * @param footprint Radius of the entity plus half the room it needs around it
+ * @param pos Set to where the entity is placed
+ * @return bool Whether a free block was found
+ */
+static bool PlaceInFreeBlock(struct placement_grid * const grid,
+                             RandomStream * const rng, double footprint,
+                             Position * const pos) {
+	unsigned int b = std::max(1.0, std::ceil(2 * footprint / grid->cell));
+	if (b > grid->cols || b > grid->rows) {
+		return false;
+	}
+	for (unsigned int tries = 0; tries < kTriesPerBlock; ++tries) {
+		unsigned int col = rng->Uniform(grid->cols - b + 1);
+		unsigned int row = rng->Uniform(grid->rows - b + 1);
+		bool free = true;
+		for (unsigned int r = row; r < row + b && free; ++r) {
+			for (unsigned int c = col; c < col + b && free; ++c) {
+				free = !grid->taken[r * grid->cols + c];
+			}
+		}
+		if (!free) {
+			continue;
+		}
+		for (unsigned int r = row; r < row + b; ++r) {
+			for (unsigned int c = col; c < col + b; ++c) {
+				grid->taken[r * grid->cols + c] = 1;
+			}
+		}
+		*pos = PlaceInBlock(*grid, rng, col, row, b, footprint);
+		return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Make an arena with many robots and obstacles placed at random,
+ * without any two entities touching at the start.
+ * @param params What kind of arena to make
+ * @param out Set to the parameters of the arena
+ * @return bool Whether everything fitted
+ */
+bool GenerateScenario(const struct generator_params& params,
+                      struct arena_params * const out) {
+	struct arena_params a;
+	InitDefaultArenaParams(&a);
+	const robot_params robot = a.robots.front();
+	const superbot_params superbot = a.superbots.front();
+	const arena_entity_params obstacle = a.obstacles.front();
+	RandomStream rng(params.seed);
+
+	// Each entity keeps half the room it needs around it to itself, so two
+	// entities whose footprints don't overlap are never in collision range
+	double max_delta = std::max(std::max(a.player.collision_delta,
+	                                     a.home_base.collision_delta),
+	                            std::max(robot.collision_delta,
+	                                     superbot.collision_delta));
+	double room = (max_delta + kClearance) / 2;
+	double cell_radius = std::max(std::max(params.robot_radius, a.player.radius),
+	                              std::max(a.home_base.radius,
+	                                       a.recharge_station.radius));
+
+	// Size a square arena so the entities cover the fraction asked for
+	if (params.x_dim == 0 || params.y_dim == 0) {
+		double lo = params.obstacle_min_radius, hi = params.obstacle_max_radius;
+		double area = M_PI * (params.n_robots * params.robot_radius *
+		                      params.robot_radius +
+		                      params.n_obstacles * (lo * lo + lo * hi + hi * hi) / 3 +
+		                      3 * cell_radius * cell_radius);
+		a.x_dim = a.y_dim = std::ceil(std::sqrt(area / params.density));
+	}
+	else {
+		a.x_dim = params.x_dim;
+		a.y_dim = params.y_dim;
+	}
+	a.seed = params.seed;
+
+	struct placement_grid grid;
+	grid.cell = 2 * (cell_radius * (1 + kJitter) + room);
+	grid.margin = kClearance;
+	grid.cols = std::max(0.0, (a.x_dim - 2 * grid.margin) / grid.cell);
+	grid.rows = std::max(0.0, (a.y_dim - 2 * grid.margin) / grid.cell);
+	grid.taken.assign(static_cast<size_t>(grid.cols) * grid.rows, 0);
+
+	// The big entities go first, while there is room for their blocks
+	if (!PlaceInFreeBlock(&grid, &rng, a.player.radius + room, &a.player.pos) ||
+	    !PlaceInFreeBlock(&grid, &rng, a.home_base.radius + room,
+	                      &a.home_base.pos) ||
+	    !PlaceInFreeBlock(&grid, &rng, a.recharge_station.radius + room,
+	                      &a.recharge_station.pos)) {
+		return false;
+	}
+	a.obstacles.assign(params.n_obstacles, obstacle);
+	for (auto& o : a.obstacles) {
+		o.radius = params.obstacle_min_radius +
+			(params.obstacle_max_radius - params.obstacle_min_radius) *
+			Uniform01(&rng);
+		if (!PlaceInFreeBlock(&grid, &rng, o.radius + room, &o.pos)) {
+			return false;
+		}
+	}
+
+	// Pick the robots' cells from the free ones, each free cell equally
+	// likely, in one pass in row order (Knuth's selection sampling)
+	size_t n_free = std::count(grid.taken.begin(), grid.taken.end(), 0);
+	if (n_free < params.n_robots) {
+		return false;
+	}
+	a.robots.assign(params.n_robots, robot);
+	size_t needed = params.n_robots;
+	auto next_robot = a.robots.begin();
+	for (size_t k = 0; k < grid.taken.size() && needed > 0; ++k) {
+		if (grid.taken[k]) {
+			continue;
+		}
+		if (Uniform01(&rng) * n_free < needed) {
+			next_robot->radius = params.robot_radius;
+			next_robot->pos = PlaceInBlock(grid, &rng, k % grid.cols, k / grid.cols,
+			                               1, params.robot_radius + room);
+			next_robot->starting_pos = next_robot->pos;
+			++next_robot;
+			--needed;
+		}
+		--n_free;
+	}
+	a.superbots.assign(params.n_robots, superbot);
+	for (auto& s : a.superbots) {
+		s.radius = params.robot_radius;
+	}
+
+	*out = std::move(a);
+	return true;
+}
+
+/**
+ * @brief Check that an arena is laid out as GenerateScenario() lays them out.
+ * @param a The arena
+ * @param problem Set to what is wrong with it, if anything is
+ * @return bool Whether the arena passed
+ */
+bool CheckScenario(const struct arena_params& a, const char ** problem) {
+	std::vector<double> x, y, radius, delta;
+	auto add = [&](const arena_entity_params& e, double collision_delta) {
+		x.push_back(e.pos.x());
+		y.push_back(e.pos.y());
+		radius.push_back(e.radius);
+		delta.push_back(collision_delta);
+	};
+	add(a.player, a.player.collision_delta);
+	add(a.home_base, a.home_base.collision_delta);
+	add(a.recharge_station, 0);
+	for (const auto& o : a.obstacles) {
+		add(o, 0);
+	}
+	for (const auto& rob : a.robots) {
+		add(rob, rob.collision_delta);
+	}
+
+	double max_radius = 0, max_delta = 0;
+	for (size_t i = 0; i < x.size(); ++i) {
+		if (x[i] - radius[i] <= 0 || x[i] + radius[i] >= a.x_dim ||
+		    y[i] - radius[i] <= 0 || y[i] + radius[i] >= a.y_dim) {
+			*problem = "an entity touches a wall";
+			return false;
+		}
+		max_radius = std::max(max_radius, radius[i]);
+		max_delta = std::max(max_delta, delta[i]);
+	}
+
+	// Two entities are in collision range when the gap between them is within
+	// the collision delta of either
+	std::vector<unsigned int> slots(x.size());
+	for (size_t i = 0; i < slots.size(); ++i) {
+		slots[i] = i;
+	}
+	SpatialHash grid;
+	grid.Init(a.x_dim, a.y_dim, 2 * max_radius + max_delta);
+	grid.Rebuild(x.data(), y.data(), radius.data(), slots.data(), slots.size());
+	std::vector<unsigned int> candidates;
+	for (size_t i = 0; i < x.size(); ++i) {
+		grid.Query(x[i], y[i], radius[i] + max_radius + max_delta, &candidates);
+		for (auto j : candidates) {
+			if (j <= i) {
+				continue;
+			}
+			double reach = radius[i] + radius[j] + std::max(delta[i], delta[j]);
+			double dx = x[j] - x[i];
+			double dy = y[j] - y[i];
+			if (dx * dx + dy * dy <= reach * reach) {
+				*problem = "two entities start within collision range";
+				return false;
+			}
+		}
+	}
+
+	// Robots each placed at the same point of their cells lie on a lattice:
+	// their coordinates all differ by multiples of the size of a cell
+	if (a.robots.size() >= kLatticeRobots) {
+		const Position& first = a.robots.front().pos;
+		long step = 0;
+		for (const auto& rob : a.robots) {
+			step = GreatestCommonDivisor(step,
+			                             static_cast<long>(rob.pos.x() - first.x()));
+			step = GreatestCommonDivisor(step,
+			                             static_cast<long>(rob.pos.y() - first.y()));
+		}
+		if (step > 1) {
+			*problem = "the robots lie on a lattice";
+			return false;
+		}
+	}
+	return true;
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,88 @@
+/**
+ * @file scenario_generator.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_SCENARIO_GENERATOR_H_
+#define SRC_SCENARIO_GENERATOR_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include "src/common.h"
+#include "src/arena_params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief What kind of arena \ref GenerateScenario() makes.
+ */
+struct generator_params {
+	generator_params(void) : n_robots(1000), n_obstacles(100), density(0.2),
+		x_dim(0), y_dim(0), robot_radius(20), obstacle_min_radius(20),
+		obstacle_max_radius(50), seed(3081) {
+	}
+
+	unsigned int n_robots; // number of robots (each with a superbot)
+	unsigned int n_obstacles; // number of obstacles
+	double density; // fraction of the arena the entities cover, if the arena is sized to fit them
+	unsigned int x_dim; // width of the arena (0 to size a square arena from density)
+	unsigned int y_dim; // height of the arena (0 to size a square arena from density)
+	double robot_radius; // radius of every robot and superbot
+	double obstacle_min_radius; // smallest obstacle radius; radii are spread evenly up to the largest
+	double obstacle_max_radius; // largest obstacle radius
+	uint64_t seed; // seed of the placement, and of the arena's random numbers
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Make an arena with many robots and obstacles placed at random,
+ * without any two entities (or an entity and a wall) touching at the start,
+ * in time linear in the number of entities.
+ *
+ * The arena is divided into a grid of square cells large enough to hold a
+ * robot, the player, the home base or the recharge station with room to spare
+ * for their collision delta, and a quarter of the largest radius more on each
+ * side, so each can be jittered. Each of those gets a cell of its own and
+ * each obstacle a square block of cells, and every entity is placed at a
+ * random point of its cell or block that keeps it inside, so entities can't
+ * overlap however they are jittered. The obstacles and the three fixed
+ * entities are placed first, at random free blocks; the robots then take a
+ * random selection of the cells left, in row order, so robots next to each
+ * other in the arena are also next to each other in memory.
+ *
+ * Everything else (colors, collision and angle deltas, battery, superbots)
+ * is as in the default game.
+ *
+ * @param params What kind of arena to make
+ * @param out Set to the parameters of the arena
+ * @return bool Whether everything fitted; it doesn't if the arena is too
+ * small for the entities asked for
+ */
+bool GenerateScenario(const struct generator_params& params,
+                      struct arena_params * const out);
+
+/**
+ * @brief Check that an arena is laid out as \ref GenerateScenario() lays them
+ * out: no entity touching a wall, no two entities within collision range of
+ * each other, and the robots not all at the same point of their cells, which
+ * would line them up on a lattice the size of a cell.
+ * @param a The arena
+ * @param problem Set to what is wrong with it, if anything is
+ * @return bool Whether the arena passed
+ */
+bool CheckScenario(const struct arena_params& a, const char ** problem);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SCENARIO_GENERATOR_H_
@@ -0,0 +1,128 @@
+/**
+ * @file scenariogen.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include "src/arena_params.h"
+#include "src/scenario.h"
+#include "src/scenario_generator.h"
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Print the command line usage of the scenario generator.
+ * @param prog Name the program was invoked with
+ */
+static void PrintUsage(const char * prog) {
+	csci3081::generator_params defaults;
+	fprintf(stderr,
+	        "Usage: %s [-n robots] [-m obstacles] [-D density] [-x width -y height] [-r radius] [-o min,max] [-s seed] [-b] [-c] scenario\n"
+	        "  -n robots     Number of robots (default %u)\n"
+	        "  -m obstacles  Number of obstacles (default %u)\n"
+	        "  -D density    Fraction of a square arena the entities cover (default %g)\n"
+	        "  -x width      Width of the arena, instead of sizing it from the density\n"
+	        "  -y height     Height of the arena, instead of sizing it from the density\n"
+	        "  -r radius     Radius of the robots (default %g)\n"
+	        "  -o min,max    Range of obstacle radii (default %g,%g)\n"
+	        "  -s seed       Seed of the placement and of the game (default %llu)\n"
+	        "  -b            Write the scenario in binary rather than text\n"
+	        "  -c            Check the placement before writing the scenario\n",
+	        prog, defaults.n_robots, defaults.n_obstacles, defaults.density,
+	        defaults.robot_radius, defaults.obstacle_min_radius,
+	        defaults.obstacle_max_radius,
+	        static_cast<unsigned long long>(defaults.seed));
+}
+
+/**
+ * @brief Generate an arena with many robots and obstacles placed at random,
+ * none touching another, and write it to a scenario file for the viewer or
+ * arenasim to load with -f.
+ */
+int main(int argc, char **argv) {
+	csci3081::generator_params gparams;
+	enum csci3081::scenario_format format = csci3081::kScenarioText;
+	bool check = false;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:m:D:x:y:r:o:s:bch")) != -1) {
+		switch (opt) {
+		case 'n':
+			gparams.n_robots = strtoul(optarg, NULL, 10);
+			break;
+		case 'm':
+			gparams.n_obstacles = strtoul(optarg, NULL, 10);
+			break;
+		case 'D':
+			gparams.density = strtod(optarg, NULL);
+			break;
+		case 'x':
+			gparams.x_dim = strtoul(optarg, NULL, 10);
+			break;
+		case 'y':
+			gparams.y_dim = strtoul(optarg, NULL, 10);
+			break;
+		case 'r':
+			gparams.robot_radius = strtod(optarg, NULL);
+			break;
+		case 'o':
+			if (sscanf(optarg, "%lf,%lf", &gparams.obstacle_min_radius,
+			           &gparams.obstacle_max_radius) != 2) {
+				PrintUsage(argv[0]);
+				return 1;
+			}
+			break;
+		case 's':
+			gparams.seed = strtoull(optarg, NULL, 10);
+			break;
+		case 'b':
+			format = csci3081::kScenarioBinary;
+			break;
+		case 'c':
+			check = true;
+			break;
+		default:
+			PrintUsage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (optind != argc - 1 || gparams.density <= 0 ||
+	    gparams.robot_radius <= 0 || gparams.obstacle_min_radius <= 0 ||
+	    gparams.obstacle_max_radius < gparams.obstacle_min_radius) {
+		PrintUsage(argv[0]);
+		return 1;
+	}
+	const char * path = argv[optind];
+
+	csci3081::arena_params aparams;
+	auto start = std::chrono::steady_clock::now();
+	if (!csci3081::GenerateScenario(gparams, &aparams)) {
+		fprintf(stderr, "%u robots and %u obstacles don't fit in the arena\n",
+		        gparams.n_robots, gparams.n_obstacles);
+		return 1;
+	}
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+	const char * problem = nullptr;
+	if (check && !csci3081::CheckScenario(aparams, &problem)) {
+		fprintf(stderr, "Bad placement: %s\n", problem);
+		return 1;
+	}
+	if (!csci3081::SaveScenario(path, aparams, format)) {
+		fprintf(stderr, "Could not write the scenario to %s\n", path);
+		return 1;
+	}
+	printf("arena: %ux%u  robots: %zu  obstacles: %zu  generated in %.6f seconds\n",
+	       aparams.x_dim, aparams.y_dim, aparams.robots.size(),
+	       aparams.obstacles.size(), seconds);
+	return 0;
+}
@@ -50,4 +50,20 @@ void SensorDistress::Reset(void) {
 	activated_ = false;
 }
 
+/**
+ * @brief Write the reading of the distress sensor.
+ * @param out Where to write it
+ */
+void SensorDistress::SaveState(StateWriter * const out) const {
+	out->Write(activated_);
+}
+
+/**
+ * @brief Read back a reading written by \ref SaveState().
+ * @param in Where to read it from
+ */
+void SensorDistress::LoadState(StateReader * const in) {
+	in->Read(&activated_);
+}
+
 NAMESPACE_END(csci3081);
@@ -16,6 +16,7 @@
 #include "src/common.h"
 #include "src/event_distress.h"
 #include "src/sensor.h"
+#include "src/state_stream.h"
 
 /*******************************************************************************
  * Namespaces
@@ -70,6 +71,18 @@ public:
 	 */
 	void Reset(void);
 
+	/**
+	 * @brief Write the reading of the distress sensor.
+	 * @param out Where to write it
+	 */
+	void SaveState(StateWriter * const out) const;
+
+	/**
+	 * @brief Read back a reading written by \ref SaveState().
+	 * @param in Where to read it from
+	 */
+	void LoadState(StateReader * const in);
+
 private:
 	int activated_; // Boolean to represent if sensor is active
 };
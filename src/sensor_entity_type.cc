@@ -47,4 +47,20 @@ void SensorEntityType::Reset(void) {
 	type_ = kNone;
 }
 
+/**
+ * @brief Write the reading of the entity type sensor.
+ * @param out Where to write it
+ */
+void SensorEntityType::SaveState(StateWriter * const out) const {
+	out->Write(type_);
+}
+
+/**
+ * @brief Read back a reading written by \ref SaveState().
+ * @param in Where to read it from
+ */
+void SensorEntityType::LoadState(StateReader * const in) {
+	in->Read(&type_);
+}
+
 NAMESPACE_END(csci3081);
@@ -16,6 +16,7 @@
 #include "src/common.h"
 #include "src/event_entity_type.h"
 #include "src/sensor.h"
+#include "src/state_stream.h"
 
 /*******************************************************************************
  * Namespaces
@@ -69,6 +70,18 @@ public:
 	 */
 	void Reset(void);
 
+	/**
+	 * @brief Write the reading of the entity type sensor.
+	 * @param out Where to write it
+	 */
+	void SaveState(StateWriter * const out) const;
+
+	/**
+	 * @brief Read back a reading written by \ref SaveState().
+	 * @param in Where to read it from
+	 */
+	void LoadState(StateReader * const in);
+
 private:
 	enum entity_type type_; // type of entity detected by sensor
 };
@@ -54,4 +54,24 @@ void SensorProximity::Reset(void) {
 	activated_ = false;
 }
 
+/**
+ * @brief Write the reading of the proximity sensor.
+ * @param out Where to write it
+ */
+void SensorProximity::SaveState(StateWriter * const out) const {
+	out->Write(activated_);
+	out->Write(point_of_contact_);
+	out->Write(angle_of_contact_);
+}
+
+/**
+ * @brief Read back a reading written by \ref SaveState().
+ * @param in Where to read it from
+ */
+void SensorProximity::LoadState(StateReader * const in) {
+	in->Read(&activated_);
+	in->Read(&point_of_contact_);
+	in->Read(&angle_of_contact_);
+}
+
 NAMESPACE_END(csci3081);
@@ -16,6 +16,7 @@
 #include "src/common.h"
 #include "src/event_collision.h"
 #include "src/sensor.h"
+#include "src/state_stream.h"
 
 /*******************************************************************************
  * Namespaces
@@ -102,6 +103,18 @@ public:
 	 */
 	void Reset(void);
 
+	/**
+	 * @brief Write the reading of the touch sensor.
+	 * @param out Where to write it
+	 */
+	void SaveState(StateWriter * const out) const;
+
+	/**
+	 * @brief Read back a reading written by \ref SaveState().
+	 * @param in Where to read it from
+	 */
+	void LoadState(StateReader * const in);
+
 private:
 	int activated_; // Boolean to represent if sensor is active
 	Position point_of_contact_; // The position of where a sensor touches an entity
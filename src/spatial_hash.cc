@@ -0,0 +1,192 @@
+/**
+ * @file spatial_hash.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include "src/spatial_hash.h"
+#include "src/narrow_phase.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+/**
+ * @brief SpatialHash constructor
+ */
+SpatialHash::SpatialHash(void) :
+	cell_size_(1), inv_cell_size_(1), n_cols_(1), n_rows_(1),
+	cell_start_(2, 0), entries_(), entity_cell_(), entry_x_(), entry_y_(),
+	entry_radius_(), max_radius_(0) {
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+/**
+ * @brief Set the dimensions of the grid.
+ * @param width Width of the arena in pixels
+ * @param height Height of the arena in pixels
+ * @param cell_size Length of the side of a cell in pixels
+ */
+void SpatialHash::Init(double width, double height, double cell_size) {
+	cell_size_ = std::max(cell_size, 1.0);
+	inv_cell_size_ = 1.0 / cell_size_;
+	n_cols_ = std::max(1, static_cast<int>(std::ceil(width * inv_cell_size_)));
+	n_rows_ = std::max(1, static_cast<int>(std::ceil(height * inv_cell_size_)));
+	cell_start_.assign(n_cols_ * n_rows_ + 1, 0);
+	entries_.clear();
+	entity_cell_.clear();
+	entry_x_.clear();
+	entry_y_.clear();
+	entry_radius_.clear();
+	max_radius_ = 0;
+}
+
+/**
+ * @brief Get the column of the cell containing an x coordinate, clamped to
+ * the grid.
+ */
+int SpatialHash::CellX(double x) const {
+	int cx = static_cast<int>(std::floor(x * inv_cell_size_));
+	return std::min(std::max(cx, 0), n_cols_ - 1);
+}
+
+/**
+ * @brief Get the row of the cell containing a y coordinate, clamped to the
+ * grid.
+ */
+int SpatialHash::CellY(double y) const {
+	int cy = static_cast<int>(std::floor(y * inv_cell_size_));
+	return std::min(std::max(cy, 0), n_rows_ - 1);
+}
+
+/**
+ * @brief Bucket a set of entity centers into the grid.
+ * @param x The x coordinate of each entity, by slot
+ * @param y The y coordinate of each entity, by slot
+ * @param radius Radius of each entity, by slot
+ * @param slots Slots of the entities to bucket, in increasing order
+ * @param n Number of entities to bucket
+ */
+void SpatialHash::Rebuild(const double * x, const double * y,
+                          const double * radius, const unsigned int * slots,
+                          size_t n) {
+	std::fill(cell_start_.begin(), cell_start_.end(), 0);
+	entity_cell_.resize(n);
+	entries_.resize(n);
+	entry_x_.resize(n);
+	entry_y_.resize(n);
+	entry_radius_.resize(n);
+	max_radius_ = 0;
+
+	// Count the entities in each cell...
+	for (size_t k = 0; k < n; ++k) {
+		unsigned int i = slots[k];
+		unsigned int cell = CellY(y[i]) * n_cols_ + CellX(x[i]);
+		entity_cell_[k] = cell;
+		cell_start_[cell]++;
+	}
+
+	// ...turn the counts into the offset just past the end of each cell...
+	size_t n_cells = cell_start_.size() - 1;
+	for (size_t c = 1; c < n_cells; ++c) {
+		cell_start_[c] += cell_start_[c - 1];
+	}
+	cell_start_[n_cells] = n;
+
+	// ...and fill each cell from the back. Walking the entities in reverse
+	// leaves every cell's entries sorted by slot, and each cell_start_ entry
+	// pointing at the start of its cell.
+	for (size_t k = n; k-- > 0;) {
+		unsigned int i = slots[k];
+		unsigned int e = --cell_start_[entity_cell_[k]];
+		entries_[e] = i;
+		entry_x_[e] = x[i];
+		entry_y_[e] = y[i];
+		entry_radius_[e] = radius[i];
+		max_radius_ = std::max(max_radius_, radius[i]);
+	}
+}
+
+/**
+ * @brief Update the centers kept for a range of the grid's entries without
+ * moving any entity to another cell.
+ * @param x The x coordinate of each entity, by slot
+ * @param y The y coordinate of each entity, by slot
+ * @param begin First entry to update
+ * @param end One past the last entry to update
+ */
+void SpatialHash::Refresh(const double * x, const double * y, size_t begin,
+                          size_t end) {
+	for (size_t e = begin; e < end; ++e) {
+		entry_x_[e] = x[entries_[e]];
+		entry_y_[e] = y[entries_[e]];
+	}
+}
+
+/**
+ * @brief Find all entities that could be within reach of a point.
+ * @param x The x coordinate of the query point
+ * @param y The y coordinate of the query point
+ * @param reach Largest center to center distance of interest
+ * @param out Filled with the candidate slots, in increasing order
+ */
+void SpatialHash::Query(double x, double y, double reach,
+                        std::vector<unsigned int> * const out) const {
+	out->clear();
+	int x0 = CellX(x - reach), x1 = CellX(x + reach);
+	int y0 = CellY(y - reach), y1 = CellY(y + reach);
+	for (int cy = y0; cy <= y1; ++cy) {
+		for (int cx = x0; cx <= x1; ++cx) {
+			unsigned int cell = cy * n_cols_ + cx;
+			out->insert(out->end(), entries_.begin() + cell_start_[cell],
+			            entries_.begin() + cell_start_[cell + 1]);
+		}
+	}
+	std::sort(out->begin(), out->end());
+}
+
+/**
+ * @brief Find all entities whose circle is within reach of a point.
+ * @param x The x coordinate of the query point
+ * @param y The y coordinate of the query point
+ * @param reach Largest distance from the point to the edge of an entity of
+ * interest
+ * @param slack Farthest any entity has moved since it was bucketed
+ * @param out Filled with the slots of the entities within reach, in
+ * increasing order
+ */
+void SpatialHash::QueryCircles(double x, double y, double reach, double slack,
+                               std::vector<unsigned int> * const out) const {
+	out->clear();
+	double extent = reach + max_radius_ + slack;
+	int x0 = CellX(x - extent), x1 = CellX(x + extent);
+	int y0 = CellY(y - extent), y1 = CellY(y + extent);
+	for (int cy = y0; cy <= y1; ++cy) {
+		// The cells of a row are next to each other, so their entries are too
+		unsigned int begin = cell_start_[cy * n_cols_ + x0];
+		unsigned int end = cell_start_[cy * n_cols_ + x1 + 1];
+		for (unsigned int b = begin; b < end; b += kCircleBlock) {
+			size_t n = std::min<size_t>(kCircleBlock, end - b);
+			uint64_t mask = CircleHitMask(x, y, reach, &entry_x_[b], &entry_y_[b],
+			                              &entry_radius_[b], n);
+			while (mask) {
+				out->push_back(entries_[b + __builtin_ctzll(mask)]);
+				mask &= mask - 1;
+			}
+		}
+	}
+	std::sort(out->begin(), out->end());
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,158 @@
+/**
+ * @file spatial_hash.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_SPATIAL_HASH_H_
+#define SRC_SPATIAL_HASH_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <vector>
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A uniform grid broad phase over the arena, used to find the entities
+ * that could possibly be touching a given point without testing every entity.
+ *
+ * The arena is divided into square cells of \ref cell_size() pixels. Each
+ * call to \ref Rebuild() buckets a set of entities, given by their slots in
+ * the arrays passed to it, by the cell their center lies in (entities
+ * outside the arena are clamped into the border cells), and
+ * \ref Query() returns the slots of all entities whose cells overlap a
+ * square around the query point. Callers must still do the exact
+ * (narrow phase) test on the returned candidates.
+ *
+ * The grid also keeps a copy of each entity's center and radius next to its
+ * slot, so the entities of a row of cells sit in contiguous arrays.
+ * \ref QueryCircles() runs the batched \ref CircleHitMask() over those,
+ * returning only the entities actually within reach.
+ *
+ * Rebuilding is a counting sort, so it is O(N) and reuses its storage from
+ * one tick to the next.
+ */
+class SpatialHash {
+public:
+	/**
+	 * @brief SpatialHash constructor. The grid is empty until \ref Init() is
+	 * called.
+	 */
+	SpatialHash(void);
+
+	/**
+	 * @brief Set the dimensions of the grid.
+	 * @param width Width of the arena in pixels
+	 * @param height Height of the arena in pixels
+	 * @param cell_size Length of the side of a cell in pixels. This should be
+	 * at least as large as the largest distance that will be queried.
+	 */
+	void Init(double width, double height, double cell_size);
+
+	/**
+	 * @brief Bucket a set of entity centers into the grid, replacing whatever
+	 * was there before.
+	 * @param x The x coordinate of each entity, by slot
+	 * @param y The y coordinate of each entity, by slot
+	 * @param radius Radius of each entity, by slot
+	 * @param slots Slots of the entities to bucket, in increasing order
+	 * @param n Number of entities to bucket
+	 */
+	void Rebuild(const double * x, const double * y, const double * radius,
+	             const unsigned int * slots, size_t n);
+
+	/**
+	 * @brief Update the centers kept for a range of the grid's entries
+	 * without moving any entity to another cell.
+	 *
+	 * Entities that moved since \ref Rebuild() are then tested where they
+	 * are, but still found through the cell they were in, so queries must
+	 * allow for how far they moved (see \ref QueryCircles()).
+	 *
+	 * @param x The x coordinate of each entity, by slot
+	 * @param y The y coordinate of each entity, by slot
+	 * @param begin First entry to update
+	 * @param end One past the last entry to update (at most \ref size())
+	 */
+	void Refresh(const double * x, const double * y, size_t begin, size_t end);
+
+	/**
+	 * @brief Find all entities that could be within reach of a point.
+	 * @param x The x coordinate of the query point
+	 * @param y The y coordinate of the query point
+	 * @param reach Largest center to center distance of interest
+	 * @param out Filled with the candidate slots, in increasing order, so
+	 * that callers visit candidates in the same order as a linear scan would
+	 */
+	void Query(double x, double y, double reach,
+	           std::vector<unsigned int> * const out) const;
+
+	/**
+	 * @brief Find all entities whose circle is within reach of a point.
+	 * @param x The x coordinate of the query point
+	 * @param y The y coordinate of the query point
+	 * @param reach Largest distance from the point to the edge of an entity
+	 * of interest
+	 * @param slack Farthest any entity has moved since it was bucketed by
+	 * \ref Rebuild()
+	 * @param out Filled with the slots of the entities within reach, in
+	 * increasing order
+	 */
+	void QueryCircles(double x, double y, double reach, double slack,
+	                  std::vector<unsigned int> * const out) const;
+
+	/**
+	 * @brief Gets the number of entities bucketed by the last rebuild
+	 * @return size_t Number of entities in the grid
+	 */
+	size_t size(void) const {
+		return entries_.size();
+	}
+
+	/**
+	 * @brief Gets the length of the side of a grid cell
+	 * @return double Cell size in pixels
+	 */
+	double cell_size(void) const {
+		return cell_size_;
+	}
+
+private:
+	/**
+	 * @brief Get the column of the cell containing an x coordinate, clamped to
+	 * the grid.
+	 */
+	int CellX(double x) const;
+
+	/**
+	 * @brief Get the row of the cell containing a y coordinate, clamped to the
+	 * grid.
+	 */
+	int CellY(double y) const;
+
+	double cell_size_; // length of the side of a cell in pixels
+	double inv_cell_size_; // 1 / cell_size_
+	int n_cols_; // number of cells across the arena
+	int n_rows_; // number of cells down the arena
+	std::vector<unsigned int> cell_start_; // offset of each cell's entries in entries_ (plus one end marker)
+	std::vector<unsigned int> entries_; // entity slots, grouped by cell
+	std::vector<unsigned int> entity_cell_; // cell of each bucketed entity, from the last rebuild
+	std::vector<double> entry_x_; // x coordinate of the entity of each entry
+	std::vector<double> entry_y_; // y coordinate of the entity of each entry
+	std::vector<double> entry_radius_; // radius of the entity of each entry
+	double max_radius_; // radius of the largest entity, from the last rebuild
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SPATIAL_HASH_H_
@@ -0,0 +1,154 @@
+/**
+ * @file state_stream.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_STATE_STREAM_H_
+#define SRC_STATE_STREAM_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "src/common.h"
+#include "src/position.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Appends the simulation state of objects to a block of bytes, for
+ * \ref Arena::Snapshot().
+ *
+ * Values are written as their raw bytes, one after another with no padding or
+ * tags, so a \ref StateReader has to read them back in the same order and
+ * with the same types. The bytes are only meant to be read back by the same
+ * build on the same machine.
+ */
+class StateWriter {
+public:
+	/**
+	 * @brief StateWriter constructor
+	 * @param out Bytes to append to
+	 */
+	explicit StateWriter(std::vector<uint8_t> * out) : out_(out) {
+	}
+
+	StateWriter(const StateWriter& other) = delete;
+	StateWriter& operator=(const StateWriter& other) = delete;
+
+	/**
+	 * @brief Append a value.
+	 * @param value A number, enum or other trivially copyable value
+	 */
+	template <class T>
+	void Write(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value,
+		              "only plain values can be written");
+		size_t at = out_->size();
+		out_->resize(at + sizeof(T));
+		std::memcpy(out_->data() + at, &value, sizeof(T));
+	}
+
+	/**
+	 * @brief Append a position, as its x and then its y coordinate. Positions
+	 * are whole pixels, so each coordinate takes 4 bytes.
+	 * @param pos The position
+	 */
+	void Write(const Position& pos) {
+		Write(static_cast<int32_t>(pos.x()));
+		Write(static_cast<int32_t>(pos.y()));
+	}
+
+private:
+	std::vector<uint8_t> * out_; // bytes written so far
+};
+
+/**
+ * @brief Reads back the simulation state a \ref StateWriter wrote, for
+ * \ref Arena::Restore().
+ *
+ * Reading past the end doesn't touch the value being read and marks the
+ * reader as failed, so a file that was cut short can be read to the end and
+ * checked once.
+ */
+class StateReader {
+public:
+	/**
+	 * @brief StateReader constructor
+	 * @param data First byte to read
+	 * @param size Number of bytes that can be read
+	 */
+	StateReader(const uint8_t * data, size_t size) : data_(data),
+		end_(data + size), failed_(false) {
+	}
+
+	StateReader(const StateReader& other) = delete;
+	StateReader& operator=(const StateReader& other) = delete;
+
+	/**
+	 * @brief Read the next value.
+	 * @param value Set to the value read
+	 * @return bool Whether there was a whole value left to read
+	 */
+	template <class T>
+	bool Read(T * const value) {
+		static_assert(std::is_trivially_copyable<T>::value,
+		              "only plain values can be read");
+		if (remaining() < sizeof(T)) {
+			data_ = end_;
+			failed_ = true;
+			return false;
+		}
+		std::memcpy(value, data_, sizeof(T));
+		data_ += sizeof(T);
+		return true;
+	}
+
+	/**
+	 * @brief Read the next position.
+	 * @param pos Set to the position read
+	 * @return bool Whether there was a whole position left to read
+	 */
+	bool Read(Position * const pos) {
+		int32_t x = 0, y = 0;
+		if (!Read(&x) || !Read(&y)) {
+			return false;
+		}
+		*pos = Position(x, y);
+		return true;
+	}
+
+	/**
+	 * @brief Get the number of bytes left to read.
+	 */
+	size_t remaining(void) const {
+		return end_ - data_;
+	}
+
+	/**
+	 * @brief Whether anything was read past the end.
+	 */
+	bool failed(void) const {
+		return failed_;
+	}
+
+private:
+	const uint8_t * data_; // next byte to read
+	const uint8_t * end_; // one past the last byte that can be read
+	bool failed_; // whether anything was read past the end
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_STATE_STREAM_H_
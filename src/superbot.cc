@@ -15,11 +15,6 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
-/*******************************************************************************
- * Static Variables
- ******************************************************************************/
-uint SuperBot::next_id_ = 0;
-
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -30,7 +25,6 @@ uint SuperBot::next_id_ = 0;
 SuperBot::SuperBot(const struct superbot_params* const params) :
 	Robot(params),
 	frozen_(0),
-	id_(-1),
 	heading_angle_(0),
 	angle_delta_(params->angle_delta),
 	starting_pos_(params->starting_pos),
@@ -42,6 +36,7 @@ SuperBot::SuperBot(const struct superbot_params* const params) :
 	sensor_proximity_2_(),
 	sensor_distress_(),
 	sensor_entity_type_() {
+	set_type(kSuperBot);
 	motion_handler_.set_speed(0);
 }
 
@@ -49,7 +44,6 @@ SuperBot::SuperBot(const struct superbot_params* const params) :
  * @brief Superbot destructor
  */
 SuperBot::~SuperBot(void) {
-	delete this;
 }
 
 /*******************************************************************************
@@ -61,14 +55,33 @@ SuperBot::~SuperBot(void) {
  * @param dt The # of timesteps that have elapsed since the last update.
  */
 void SuperBot::TimestepUpdate(uint dt) {
-	// Update heading and speed as indicated by touch sensor
-	motion_handler_.UpdateVelocity(sensor_touch_);
+	Position old_pos = get_pos();
 
-	motion_handler_.UpdateVelocity(sensor_proximity_1_);
+	UpdateVelocity();
 
 	// Use velocity and position to update position
 	motion_behavior_.UpdatePosition(this, dt);
 
+	PositionUpdated(old_pos, dt);
+}
+
+/**
+ * @brief Update the superbot's heading and speed from its sensors.
+ */
+void SuperBot::UpdateVelocity(void) {
+	// Update heading and speed as indicated by touch sensor
+	motion_handler_.UpdateVelocity(sensor_touch_);
+
+	motion_handler_.UpdateVelocity(sensor_proximity_1_);
+}
+
+/**
+ * @brief Remember where the superbot moved to.
+ * @param old_pos Position of the superbot before it moved
+ * @param dt The # of timesteps the superbot moved for
+ */
+void SuperBot::PositionUpdated(__unused const Position& old_pos,
+                         __unused uint dt) {
 	old_pos_ = get_pos();
 }
 
@@ -128,4 +141,37 @@ void SuperBot::Reset(void) {
 	set_pos(pos);
 }
 
+/**
+ * @brief Write the superbot's position, frozen flag, actuators and sensors. The robot it is
+ * built on is written first.
+ * @param out Where to write them
+ */
+void SuperBot::SaveState(StateWriter * const out) const {
+	Robot::SaveState(out);
+	out->Write(frozen_);
+	out->Write(old_pos_);
+	motion_handler_.SaveState(out);
+	sensor_touch_.SaveState(out);
+	sensor_proximity_1_.SaveState(out);
+	sensor_proximity_2_.SaveState(out);
+	sensor_distress_.SaveState(out);
+	sensor_entity_type_.SaveState(out);
+}
+
+/**
+ * @brief Read back the state written by SaveState().
+ * @param in Where to read it from
+ */
+void SuperBot::LoadState(StateReader * const in) {
+	Robot::LoadState(in);
+	in->Read(&frozen_);
+	in->Read(&old_pos_);
+	motion_handler_.LoadState(in);
+	sensor_touch_.LoadState(in);
+	sensor_proximity_1_.LoadState(in);
+	sensor_proximity_2_.LoadState(in);
+	sensor_distress_.LoadState(in);
+	sensor_entity_type_.LoadState(in);
+}
+
 NAMESPACE_END(csci3081);
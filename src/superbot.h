@@ -60,6 +60,20 @@ public:
 	 */
 	void Reset(void) override;
 
+	/**
+	 * @brief Write the superbot's position, frozen flag, actuators and
+	 * sensors. The robot it is
+	 * built on is written first.
+	 * @param out Where to write them
+	 */
+	void SaveState(StateWriter * const out) const override;
+
+	/**
+	 * @brief Read back the state written by \ref SaveState().
+	 * @param in Where to read it from
+	 */
+	void LoadState(StateReader * const in) override;
+
 	/**
 	 * @brief Update the superbot's position and velocity after the specified
 	 * duration has passed.
@@ -67,6 +81,18 @@ public:
 	 */
 	void TimestepUpdate(unsigned int dt) override;
 
+	/**
+	 * @brief Update the superbot's heading and speed from its sensors.
+	 */
+	void UpdateVelocity(void) override;
+
+	/**
+	 * @brief Remember where the superbot moved to.
+	 * @param old_pos Position of the superbot before it moved
+	 * @param dt The # of timesteps the superbot moved for
+	 */
+	void PositionUpdated(const Position& old_pos, unsigned int dt) override;
+
 	/**
 	 * @brief  Pass along a collision event (from arena) to the touch sensor.
 	 * This method provides a framework in which sensors can get different types
@@ -171,9 +197,7 @@ public:
 	}
 
 private:
-	static unsigned int next_id_; // id of the next robot in system
 	int frozen_; // boolean to show whether robot is frozen or not
-	int id_; // id of this robot
 	double heading_angle_; // angle in degrees the robot is travelling
 	double angle_delta_; // change in heading anlge of robot since last update
 	Position starting_pos_; // starting position of robot
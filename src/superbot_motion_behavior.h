@@ -10,7 +10,7 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <Eigen/Dense>
+#include <cmath>
 #include "src/common.h"
 
 /*******************************************************************************
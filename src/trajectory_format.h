@@ -0,0 +1,237 @@
+/**
+ * @file trajectory_format.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_TRAJECTORY_FORMAT_H_
+#define SRC_TRAJECTORY_FORMAT_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "src/common.h"
+#include "src/entity_type.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+/*
+ * A trajectory file starts with a header: kTrajectoryMagic, kTrajectoryVersion,
+ * the number of entities, the keyframe interval, then the type and id of each
+ * entity (see trajectory_entity). Then come chunks of consecutive ticks, an
+ * index of the chunks, and a trailer that locates the index.
+ *
+ * Each chunk starts with kTrajectoryChunkMagic, the number of ticks in it,
+ * the first tick, and the size in bytes of each column. A block table comes
+ * next: for each column, for each tick, for each block of
+ * kTrajectoryBlockEntities entities, the offset (uint32_t) of the block's
+ * first value from the start of the column. Then the columns, one after
+ * another, and zero bytes up to a multiple of 8. A column holds one value per
+ * entity per tick, tick by tick, so a value can be found by skipping at most
+ * a block's worth of values.
+ *
+ * Every value is a varint (see PutVarint()): in the first tick of a chunk
+ * (its keyframe) it is coded against 0, and in the others against the same
+ * entity's value in the tick before, so each chunk can be decoded on its own.
+ * Coordinates are coded as their difference and flags as their XOR with the
+ * earlier value. Headings and speeds are doubles; a difference that is a
+ * whole number is coded like a coordinate's, shifted left one bit, and
+ * anything else as a 1 followed by the raw 8 bytes of the value, so nothing
+ * is lost.
+ *
+ * The index has one trajectory_index_entry per chunk, in the order they were
+ * written, and the trailer (trajectory_trailer) is the last bytes of the
+ * file. A file whose recording never finished has no index, but its chunks
+ * can still be found by walking them from the header.
+ *
+ * All numbers are in the byte order of the machine that wrote the file.
+ */
+
+// First bytes of a trajectory file, and the version of its layout
+static const uint32_t kTrajectoryMagic = 0x4a544152; // "RATJ"
+static const uint32_t kTrajectoryVersion = 2;
+
+// First bytes of each chunk
+static const uint32_t kTrajectoryChunkMagic = 0x4b484352; // "RCHK"
+
+// Magic number of the trailer
+static const uint32_t kTrajectoryIndexMagic = 0x58444952; // "RIDX"
+
+// Entities per block of the block table
+static const unsigned int kTrajectoryBlockEntities = 256;
+
+// Ticks between keyframes when none is asked for
+static const unsigned int kDefaultKeyframeInterval = 64;
+
+// Bits of the flags column
+static const uint8_t kTrajectoryFrozen = 1 << 0; // a robot or superbot that is frozen
+static const uint8_t kTrajectorySuperBot = 1 << 1; // a robot slot taken by its superbot
+static const uint8_t kTrajectoryPaused = 1 << 2; // a player paused after a collision
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief The columns of a trajectory, in the order they appear in a chunk.
+ */
+enum trajectory_column {
+	kColumnX, // x coordinate, in whole pixels
+	kColumnY, // y coordinate, in whole pixels
+	kColumnHeading, // heading angle in degrees
+	kColumnSpeed, // speed
+	kColumnFlags, // kTrajectory* bits
+	kNumColumns,
+};
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief Which entity a trajectory follows. A robot keeps its entry when it
+ * is promoted; the kTrajectorySuperBot flag tells the ticks it spent as a
+ * superbot.
+ */
+struct trajectory_entity {
+	trajectory_entity(void) : type(0), id(0) {
+	}
+
+	uint32_t type; // the entity_type of the entity (kPlayer, kHomebase or kRobot)
+	uint32_t id; // the id the arena gave the entity (see ArenaEntity::get_id())
+};
+
+/**
+ * @brief Where a chunk is, in the index at the end of a trajectory file.
+ */
+struct trajectory_index_entry {
+	trajectory_index_entry(void) : first_tick(0), offset(0), n_ticks(0),
+		reserved(0) {
+	}
+
+	uint64_t first_tick; // first tick in the chunk
+	uint64_t offset; // offset of the chunk from the start of the file
+	uint32_t n_ticks; // ticks in the chunk
+	uint32_t reserved; // always 0
+};
+
+/**
+ * @brief The last bytes of a trajectory file.
+ */
+struct trajectory_trailer {
+	trajectory_trailer(void) : index_offset(0), n_chunks(0),
+		magic(kTrajectoryIndexMagic), version(kTrajectoryVersion) {
+	}
+
+	uint64_t index_offset; // offset of the index from the start of the file
+	uint64_t n_chunks; // entries in the index
+	uint32_t magic; // kTrajectoryIndexMagic
+	uint32_t version; // kTrajectoryVersion
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Append a number 7 bits at a time, low bits first, with the top bit
+ * of each byte set if more follow.
+ */
+inline void PutVarint(uint64_t v, std::vector<uint8_t> * const out) {
+	while (v >= 0x80) {
+		out->push_back(static_cast<uint8_t>(v) | 0x80);
+		v >>= 7;
+	}
+	out->push_back(static_cast<uint8_t>(v));
+}
+
+/**
+ * @brief Read a number PutVarint() wrote.
+ * @param at The first byte; moved past the number
+ * @param end One past the last byte that can be read
+ * @param v Set to the number
+ * @return bool Whether a whole number was there
+ */
+inline bool GetVarint(const uint8_t ** const at, const uint8_t * end,
+                      uint64_t * const v) {
+	uint64_t result = 0;
+	for (unsigned int shift = 0; *at < end && shift < 64; shift += 7) {
+		uint8_t byte = *(*at)++;
+		result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			*v = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Map a signed number to an unsigned one, small magnitudes to small
+ * numbers (0, -1, 1, -2, ... to 0, 1, 2, 3, ...).
+ */
+inline uint64_t ZigZag(int64_t v) {
+	return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+/**
+ * @brief Undo ZigZag().
+ */
+inline int64_t UnZigZag(uint64_t v) {
+	return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+/**
+ * @brief Append a double, coded against an earlier value.
+ */
+inline void PutDouble(double v, double prev, std::vector<uint8_t> * const out) {
+	double d = v - prev;
+	if (d > -1e15 && d < 1e15) {
+		int64_t whole = static_cast<int64_t>(d);
+		double back = prev + static_cast<double>(whole);
+		if (std::memcmp(&back, &v, sizeof(v)) == 0) {
+			PutVarint(ZigZag(whole) << 1, out);
+			return;
+		}
+	}
+	out->push_back(1);
+	const uint8_t * bytes = reinterpret_cast<const uint8_t*>(&v);
+	out->insert(out->end(), bytes, bytes + sizeof(v));
+}
+
+/**
+ * @brief Read a double PutDouble() wrote.
+ * @param at The first byte; moved past the value
+ * @param end One past the last byte that can be read
+ * @param prev The value it was coded against
+ * @param v Set to the value
+ * @return bool Whether a whole value was there
+ */
+inline bool GetDouble(const uint8_t ** const at, const uint8_t * end,
+                      double prev, double * const v) {
+	uint64_t code;
+	if (!GetVarint(at, end, &code)) {
+		return false;
+	}
+	if (!(code & 1)) {
+		*v = prev + static_cast<double>(UnZigZag(code >> 1));
+		return true;
+	}
+	if (code != 1 || end - *at < static_cast<ptrdiff_t>(sizeof(*v))) {
+		return false;
+	}
+	std::memcpy(v, *at, sizeof(*v));
+	*at += sizeof(*v);
+	return true;
+}
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRAJECTORY_FORMAT_H_
@@ -0,0 +1,414 @@
+/**
+ * @file trajectory_reader.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "src/trajectory_reader.h"
+#include "src/state_stream.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+// Bytes of the file header before the entity table
+static const size_t kHeaderSize = 4 * sizeof(uint32_t);
+
+// Bytes of each entry of the entity table
+static const size_t kEntitySize = 2 * sizeof(uint32_t);
+
+// Bytes of the fixed part of a chunk, before its block table
+static const size_t kChunkHeaderSize = 2 * sizeof(uint32_t) +
+	(1 + kNumColumns) * sizeof(uint64_t);
+
+// Bytes of each entry of the index
+static const size_t kIndexEntrySize = 2 * sizeof(uint64_t) +
+	2 * sizeof(uint32_t);
+
+// Bytes of the trailer
+static const size_t kTrailerSize = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Read one value of a column, coded against an earlier one.
+ * @param column Column the value is in
+ * @param at The first byte; moved past the value
+ * @param end One past the last byte of the column
+ * @param prev The value it was coded against
+ * @param v Set to the value
+ * @return bool Whether a whole value was there
+ */
+static bool GetValue(enum trajectory_column column, const uint8_t ** const at,
+                     const uint8_t * end, double prev, double * const v) {
+	if (column == kColumnHeading || column == kColumnSpeed) {
+		return GetDouble(at, end, prev, v);
+	}
+	uint64_t code;
+	if (!GetVarint(at, end, &code)) {
+		return false;
+	}
+	if (column == kColumnFlags) {
+		*v = static_cast<double>(static_cast<uint64_t>(prev) ^ code);
+	}
+	else {
+		*v = prev + static_cast<double>(UnZigZag(code));
+	}
+	return true;
+}
+
+/**
+ * @brief Step over values of a column without decoding them.
+ * @param column Column the values are in
+ * @param count Number of values to step over
+ * @param at The first byte; moved past the values
+ * @param end One past the last byte of the column
+ * @return bool Whether that many whole values were there
+ */
+static bool SkipValues(enum trajectory_column column, size_t count,
+                       const uint8_t ** const at, const uint8_t * end) {
+	bool doubles = column == kColumnHeading || column == kColumnSpeed;
+	for (size_t k = 0; k < count; ++k) {
+		uint64_t code;
+		if (!GetVarint(at, end, &code)) {
+			return false;
+		}
+		if (doubles && code == 1) {
+			if (end - *at < static_cast<ptrdiff_t>(sizeof(double))) {
+				return false;
+			}
+			*at += sizeof(double);
+		}
+	}
+	return true;
+}
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+/**
+ * @brief TrajectoryReader constructor. Nothing can be read until Open() is
+ * called.
+ */
+TrajectoryReader::TrajectoryReader(void) : mapped_(nullptr), data_(nullptr),
+	size_(0), entities_(), chunks_() {
+}
+
+/**
+ * @brief TrajectoryReader destructor. Unmaps the file if one is open.
+ */
+TrajectoryReader::~TrajectoryReader(void) {
+	Close();
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+/**
+ * @brief Map a trajectory file into memory, closing the one open before.
+ * @param path Path of the file
+ * @return bool Whether the file could be mapped and holds a trajectory
+ */
+bool TrajectoryReader::Open(const char * path) {
+	Close();
+	int fd = open(path, O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		return false;
+	}
+	size_t size = st.st_size;
+	void * mapped = size > 0 ?
+		mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (mapped == MAP_FAILED) {
+		return false;
+	}
+	mapped_ = mapped;
+	data_ = static_cast<const uint8_t*>(mapped);
+	size_ = size;
+
+	StateReader r(data_, size_);
+	uint32_t magic = 0, version = 0, n_entities = 0, keyframe_interval = 0;
+	r.Read(&magic);
+	r.Read(&version);
+	r.Read(&n_entities);
+	r.Read(&keyframe_interval);
+	if (r.failed() || magic != kTrajectoryMagic ||
+	    version != kTrajectoryVersion ||
+	    n_entities > r.remaining() / kEntitySize) {
+		Close();
+		return false;
+	}
+	entities_.resize(n_entities);
+	for (auto& e : entities_) {
+		r.Read(&e.type);
+		r.Read(&e.id);
+	}
+
+	if (!ReadIndex()) {
+		chunks_.clear();
+		WalkChunks(kHeaderSize + n_entities * kEntitySize);
+	}
+	// A game restored to an earlier tick records some ticks twice; sorting
+	// keeps the chunks of each in the order they were recorded
+	std::stable_sort(chunks_.begin(), chunks_.end(),
+	                 [](const trajectory_chunk& a, const trajectory_chunk& b) {
+		return a.first_tick < b.first_tick;
+	});
+	return true;
+}
+
+/**
+ * @brief Unmap the file, if one is open.
+ */
+void TrajectoryReader::Close(void) {
+	if (mapped_) {
+		munmap(mapped_, size_);
+	}
+	mapped_ = nullptr;
+	data_ = nullptr;
+	size_ = 0;
+	entities_.clear();
+	chunks_.clear();
+}
+
+/**
+ * @brief Find an entity by its type and the id the arena gave it.
+ * @param type Type of the entity
+ * @param id Id of the entity
+ * @param entity Set to the index of the entity, if it is found
+ * @return bool Whether the trajectory follows such an entity
+ */
+bool TrajectoryReader::FindEntity(enum entity_type type, uint32_t id,
+                                  size_t * const entity) const {
+	for (size_t i = 0; i < entities_.size(); ++i) {
+		if (entities_[i].type == static_cast<uint32_t>(type) &&
+		    entities_[i].id == id) {
+			*entity = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Find the chunk holding a tick, by binary search of the index.
+ * @param tick The tick
+ * @param i Set to the index of the chunk, if there is one
+ * @return bool Whether the file holds the tick
+ */
+bool TrajectoryReader::FindChunk(uint64_t tick, size_t * const i) const {
+	auto after = std::upper_bound(chunks_.begin(), chunks_.end(), tick,
+	                              [](uint64_t t, const trajectory_chunk& c) {
+		return t < c.first_tick;
+	});
+	if (after == chunks_.begin()) {
+		return false;
+	}
+	auto c = after - 1;
+	if (tick - c->first_tick >= c->n_ticks) {
+		return false;
+	}
+	*i = c - chunks_.begin();
+	return true;
+}
+
+/**
+ * @brief Read the values of one entity in one column over a run of ticks.
+ * @param entity Index of the entity
+ * @param column Column to read
+ * @param begin First tick to read
+ * @param end One past the last tick to read
+ * @param values Set to the value at each tick
+ * @return bool Whether every tick asked for is in the file and could be read
+ */
+bool TrajectoryReader::ReadEntity(size_t entity, enum trajectory_column column,
+                                  uint64_t begin, uint64_t end,
+                                  std::vector<double> * const values) const {
+	values->clear();
+	if (entity >= entities_.size() || column >= kNumColumns) {
+		return false;
+	}
+	size_t block = entity / kTrajectoryBlockEntities;
+	size_t skip = entity % kTrajectoryBlockEntities;
+	uint64_t tick = begin;
+	while (tick < end) {
+		size_t i;
+		if (!FindChunk(tick, &i)) {
+			return false;
+		}
+		const trajectory_chunk& c = chunks_[i];
+		const trajectory_column_view& view = c.columns[column];
+		uint64_t first_row = tick - c.first_tick;
+		uint64_t end_row = std::min<uint64_t>(c.n_ticks, end - c.first_tick);
+
+		// Each tick's value is coded against the tick before, back to the
+		// keyframe, so every row up to the last one asked for is read
+		double prev = 0;
+		for (uint64_t row = 0; row < end_row; ++row) {
+			uint32_t offset = view.blocks[row * n_blocks() + block];
+			const uint8_t * at = view.data + std::min<size_t>(offset, view.size);
+			const uint8_t * column_end = view.data + view.size;
+			double v;
+			if (offset > view.size || !SkipValues(column, skip, &at, column_end) ||
+			    !GetValue(column, &at, column_end, prev, &v)) {
+				return false;
+			}
+			prev = v;
+			if (row >= first_row) {
+				values->push_back(v);
+			}
+		}
+		tick = c.first_tick + end_row;
+	}
+	return true;
+}
+
+/**
+ * @brief Read the values of every entity in one column at one tick.
+ * @param tick The tick
+ * @param column Column to read
+ * @param values Set to the value of each entity
+ * @return bool Whether the tick is in the file and could be read
+ */
+bool TrajectoryReader::ReadTick(uint64_t tick, enum trajectory_column column,
+                                std::vector<double> * const values) const {
+	size_t i;
+	if (column >= kNumColumns || !FindChunk(tick, &i)) {
+		return false;
+	}
+	const trajectory_chunk& c = chunks_[i];
+	const trajectory_column_view& view = c.columns[column];
+	const uint8_t * at = view.data;
+	const uint8_t * column_end = view.data + view.size;
+	values->assign(entities_.size(), 0);
+	for (uint64_t row = 0; row <= tick - c.first_tick; ++row) {
+		for (auto& v : *values) {
+			if (!GetValue(column, &at, column_end, v, &v)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Find where the columns and block tables of the chunk at an offset
+ * are.
+ * @param offset Offset of the chunk from the start of the file
+ * @param chunk Set to the chunk
+ * @param end Set to the offset one past the chunk
+ * @return bool Whether a whole chunk is there
+ */
+bool TrajectoryReader::ParseChunk(uint64_t offset,
+                                  struct trajectory_chunk * const chunk,
+                                  uint64_t * const end) const {
+	if (offset > size_ || size_ - offset < kChunkHeaderSize) {
+		return false;
+	}
+	StateReader r(data_ + offset, size_ - offset);
+	uint32_t magic = 0;
+	uint64_t sizes[kNumColumns] = {0};
+	r.Read(&magic);
+	r.Read(&chunk->n_ticks);
+	r.Read(&chunk->first_tick);
+	for (auto& size : sizes) {
+		r.Read(&size);
+	}
+	if (magic != kTrajectoryChunkMagic || chunk->n_ticks == 0) {
+		return false;
+	}
+
+	// Block tables first, then the columns, each checked to fit in the file
+	uint64_t at = offset + kChunkHeaderSize;
+	uint64_t table = static_cast<uint64_t>(chunk->n_ticks) * n_blocks() *
+		sizeof(uint32_t);
+	for (auto& column : chunk->columns) {
+		if (size_ - at < table) {
+			return false;
+		}
+		column.blocks = reinterpret_cast<const uint32_t*>(data_ + at);
+		at += table;
+	}
+	for (int c = 0; c < kNumColumns; ++c) {
+		if (size_ - at < sizes[c]) {
+			return false;
+		}
+		chunk->columns[c].data = data_ + at;
+		chunk->columns[c].size = sizes[c];
+		at += sizes[c];
+	}
+	*end = std::min<uint64_t>(size_, (at + 7) / 8 * 8);
+	return true;
+}
+
+/**
+ * @brief Find the chunks through the index at the end of the file.
+ * @return bool Whether the file has a whole index of whole chunks
+ */
+bool TrajectoryReader::ReadIndex(void) {
+	if (size_ < kTrailerSize) {
+		return false;
+	}
+	StateReader trailer(data_ + size_ - kTrailerSize, kTrailerSize);
+	struct trajectory_trailer t;
+	trailer.Read(&t.index_offset);
+	trailer.Read(&t.n_chunks);
+	trailer.Read(&t.magic);
+	trailer.Read(&t.version);
+	if (t.magic != kTrajectoryIndexMagic || t.version != kTrajectoryVersion ||
+	    t.index_offset > size_ - kTrailerSize ||
+	    t.n_chunks != (size_ - kTrailerSize - t.index_offset) / kIndexEntrySize) {
+		return false;
+	}
+
+	StateReader r(data_ + t.index_offset, t.n_chunks * kIndexEntrySize);
+	chunks_.resize(t.n_chunks);
+	for (auto& chunk : chunks_) {
+		struct trajectory_index_entry e;
+		r.Read(&e.first_tick);
+		r.Read(&e.offset);
+		r.Read(&e.n_ticks);
+		r.Read(&e.reserved);
+		uint64_t end;
+		if (!ParseChunk(e.offset, &chunk, &end) ||
+		    chunk.first_tick != e.first_tick || chunk.n_ticks != e.n_ticks ||
+		    end > t.index_offset) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Find the chunks by walking them from the end of the header, stopping
+ * at the first that isn't whole.
+ * @param offset Offset of the first chunk
+ */
+void TrajectoryReader::WalkChunks(uint64_t offset) {
+	struct trajectory_chunk chunk;
+	uint64_t end;
+	while (ParseChunk(offset, &chunk, &end)) {
+		chunks_.push_back(chunk);
+		offset = end;
+	}
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,224 @@
+/**
+ * @file trajectory_reader.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_TRAJECTORY_READER_H_
+#define SRC_TRAJECTORY_READER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "src/common.h"
+#include "src/entity_type.h"
+#include "src/trajectory_format.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief One column of one chunk of a trajectory file, pointing straight into
+ * the mapped file.
+ */
+struct trajectory_column_view {
+	trajectory_column_view(void) : data(nullptr), size(0), blocks(nullptr) {
+	}
+
+	const uint8_t * data; // first byte of the column's values
+	size_t size; // bytes of values
+	const uint32_t * blocks; // block table: for each tick, the offset in data of each block of entities
+};
+
+/**
+ * @brief One chunk of a trajectory file: a run of consecutive ticks.
+ */
+struct trajectory_chunk {
+	trajectory_chunk(void) : first_tick(0), n_ticks(0), columns() {
+	}
+
+	uint64_t first_tick; // first tick in the chunk
+	uint32_t n_ticks; // ticks in the chunk
+	struct trajectory_column_view columns[kNumColumns]; // the chunk's columns
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Reads a trajectory file a \ref TrajectoryRecorder wrote, by mapping
+ * it into memory.
+ *
+ * Nothing is read when the file is opened beyond its header and index, and
+ * nothing is copied: a chunk's columns are handed out as pointers into the
+ * mapped file, and \ref ReadEntity() decodes just the values of one entity in
+ * one column over the ticks asked for, so reading one robot's headings
+ * touches a small part of the file however long the game was. The pages of
+ * the file are only loaded as they are touched.
+ *
+ * Entities are found by the type and id the arena gave them (see
+ * \ref ArenaEntity::get_id()). Obstacles never move, so a trajectory doesn't
+ * follow them.
+ */
+class TrajectoryReader {
+public:
+	/**
+	 * @brief TrajectoryReader constructor. Nothing can be read until
+	 * \ref Open() is called.
+	 */
+	TrajectoryReader(void);
+
+	/**
+	 * @brief TrajectoryReader destructor. Unmaps the file if one is open.
+	 */
+	~TrajectoryReader(void);
+
+	TrajectoryReader(const TrajectoryReader& other) = delete;
+	TrajectoryReader& operator=(const TrajectoryReader& other) = delete;
+
+	/**
+	 * @brief Map a trajectory file into memory, closing the one open before.
+	 *
+	 * The chunks are found through the index at the end of the file; a file
+	 * whose recording never finished has none, and its chunks are found by
+	 * walking them from the start instead, up to the last whole one.
+	 *
+	 * @param path Path of the file
+	 * @return bool Whether the file could be mapped and holds a trajectory
+	 */
+	bool Open(const char * path);
+
+	/**
+	 * @brief Unmap the file, if one is open. Every view handed out goes with
+	 * it.
+	 */
+	void Close(void);
+
+	/**
+	 * @brief Get the number of entities the trajectory follows.
+	 */
+	size_t n_entities(void) const {
+		return entities_.size();
+	}
+
+	/**
+	 * @brief Get the type and id of each entity, in the order they are
+	 * recorded in.
+	 */
+	const std::vector<struct trajectory_entity>& entities(void) const {
+		return entities_;
+	}
+
+	/**
+	 * @brief Find an entity by its type and the id the arena gave it.
+	 * @param type Type of the entity (kPlayer, kHomebase or kRobot; a robot
+	 * promoted to a superbot is still found as a kRobot)
+	 * @param id Id of the entity
+	 * @param entity Set to the index of the entity, if it is found
+	 * @return bool Whether the trajectory follows such an entity
+	 */
+	bool FindEntity(enum entity_type type, uint32_t id,
+	                size_t * const entity) const;
+
+	/**
+	 * @brief Get the number of chunks in the file.
+	 */
+	size_t n_chunks(void) const {
+		return chunks_.size();
+	}
+
+	/**
+	 * @brief Get a chunk of the file. Chunks are in order of their first tick.
+	 * @param i Index of the chunk
+	 * @return trajectory_chunk The chunk, valid until the file is closed
+	 */
+	const struct trajectory_chunk& chunk(size_t i) const {
+		return chunks_[i];
+	}
+
+	/**
+	 * @brief Find the chunk holding a tick, by binary search of the index.
+	 * @param tick The tick
+	 * @param i Set to the index of the chunk, if there is one
+	 * @return bool Whether the file holds the tick
+	 */
+	bool FindChunk(uint64_t tick, size_t * const i) const;
+
+	/**
+	 * @brief Read the values of one entity in one column over a run of ticks,
+	 * decoding only the chunks holding them, and only as much of each as it
+	 * takes to reach the entity.
+	 * @param entity Index of the entity (see \ref FindEntity())
+	 * @param column Column to read
+	 * @param begin First tick to read
+	 * @param end One past the last tick to read
+	 * @param values Set to the value at each tick; every value of every column
+	 * is exact as a double
+	 * @return bool Whether every tick asked for is in the file and could be
+	 * read
+	 */
+	bool ReadEntity(size_t entity, enum trajectory_column column,
+	                uint64_t begin, uint64_t end,
+	                std::vector<double> * const values) const;
+
+	/**
+	 * @brief Read the values of every entity in one column at one tick.
+	 * @param tick The tick
+	 * @param column Column to read
+	 * @param values Set to the value of each entity
+	 * @return bool Whether the tick is in the file and could be read
+	 */
+	bool ReadTick(uint64_t tick, enum trajectory_column column,
+	              std::vector<double> * const values) const;
+
+private:
+	/**
+	 * @brief Find where the columns and block tables of the chunk at an
+	 * offset are.
+	 * @param offset Offset of the chunk from the start of the file
+	 * @param chunk Set to the chunk
+	 * @param end Set to the offset one past the chunk
+	 * @return bool Whether a whole chunk is there
+	 */
+	bool ParseChunk(uint64_t offset, struct trajectory_chunk * const chunk,
+	                uint64_t * const end) const;
+
+	/**
+	 * @brief Find the chunks through the index at the end of the file.
+	 * @return bool Whether the file has a whole index of whole chunks
+	 */
+	bool ReadIndex(void);
+
+	/**
+	 * @brief Find the chunks by walking them from the end of the header,
+	 * stopping at the first that isn't whole.
+	 * @param offset Offset of the first chunk
+	 */
+	void WalkChunks(uint64_t offset);
+
+	/**
+	 * @brief Get the number of blocks of entities in the block tables.
+	 */
+	size_t n_blocks(void) const {
+		return (entities_.size() + kTrajectoryBlockEntities - 1) /
+			kTrajectoryBlockEntities;
+	}
+
+	void * mapped_; // the mapped file (nullptr if none is open)
+	const uint8_t * data_; // first byte of the mapped file
+	size_t size_; // size of the file
+	std::vector<struct trajectory_entity> entities_; // the entity table
+	std::vector<struct trajectory_chunk> chunks_; // the chunks, in order of their first tick
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRAJECTORY_READER_H_
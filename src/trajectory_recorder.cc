@@ -0,0 +1,341 @@
+/**
+ * @file trajectory_recorder.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "src/trajectory_recorder.h"
+#include "src/state_stream.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constant Definitions
+ ******************************************************************************/
+// Frames the arena can fill in before it has to wait for the writer
+static const unsigned int kFramesInFlight = 4;
+
+// Most bytes any one value can be coded in (a 1 and a raw double)
+static const size_t kMaxValueBytes = 1 + sizeof(double);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Size every column of a frame for n entities.
+ */
+static void ResizeFrame(size_t n, struct trajectory_frame * const frame) {
+	frame->x.resize(n);
+	frame->y.resize(n);
+	frame->heading.resize(n);
+	frame->speed.resize(n);
+	frame->flags.resize(n);
+}
+
+/**
+ * @brief Append a column of a frame to the chunk being built, noting where
+ * each block of entities starts in it.
+ * @param values The column of the frame
+ * @param previous Values of the column they are coded against
+ * @param put Appends one value coded against an earlier one
+ * @param out The column of the chunk
+ * @param blocks The column's block table
+ */
+template <class T, class Put>
+static void EncodeColumn(const std::vector<T>& values,
+                         const std::vector<T>& previous, Put put,
+                         std::vector<uint8_t> * const out,
+                         std::vector<uint32_t> * const blocks) {
+	size_t n = values.size();
+	for (size_t begin = 0; begin < n; begin += kTrajectoryBlockEntities) {
+		blocks->push_back(static_cast<uint32_t>(out->size()));
+		size_t end = std::min(n, begin + kTrajectoryBlockEntities);
+		for (size_t i = begin; i < end; ++i) {
+			put(values[i], previous[i], out);
+		}
+	}
+}
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+/**
+ * @brief TrajectoryRecorder constructor. Nothing is recorded until Open() is
+ * called.
+ */
+TrajectoryRecorder::TrajectoryRecorder(void) : file_(nullptr),
+	keyframe_interval_(kDefaultKeyframeInterval), failed_(false), frames_(),
+	free_(), ready_(), closing_(false), mutex_(), frame_freed_(),
+	frame_ready_(), writer_(), previous_(), columns_(), blocks_(), index_(),
+	chunk_ticks_(0), chunk_first_tick_(0), ticks_written_(0),
+	bytes_written_(0) {
+}
+
+/**
+ * @brief TrajectoryRecorder destructor. Closes the file if it is open.
+ */
+TrajectoryRecorder::~TrajectoryRecorder(void) {
+	Close();
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+/**
+ * @brief Start recording to a file, and start the writer thread.
+ * @param path Path of the file, which is replaced if it exists
+ * @param entities The entities each frame holds, in order
+ * @param keyframe_interval Most ticks in a chunk
+ * @return bool Whether the file could be opened
+ */
+bool TrajectoryRecorder::Open(const char * path,
+                              const std::vector<struct trajectory_entity>& entities,
+                              unsigned int keyframe_interval) {
+	Close();
+	file_ = fopen(path, "wb");
+	if (!file_) {
+		return false;
+	}
+	keyframe_interval_ = std::max(keyframe_interval, 1u);
+	failed_ = false;
+	closing_ = false;
+	chunk_ticks_ = 0;
+	index_.clear();
+	ticks_written_ = 0;
+	bytes_written_ = 0;
+
+	std::vector<uint8_t> header;
+	StateWriter w(&header);
+	w.Write(kTrajectoryMagic);
+	w.Write(kTrajectoryVersion);
+	w.Write(static_cast<uint32_t>(entities.size()));
+	w.Write(static_cast<uint32_t>(keyframe_interval_));
+	for (const auto& e : entities) {
+		w.Write(e.type);
+		w.Write(e.id);
+	}
+	WriteBytes(header.data(), header.size());
+
+	frames_.assign(kFramesInFlight, trajectory_frame());
+	free_.clear();
+	for (auto& frame : frames_) {
+		ResizeFrame(entities.size(), &frame);
+		free_.push_back(&frame);
+	}
+	ResizeFrame(entities.size(), &previous_);
+	writer_ = std::thread(&TrajectoryRecorder::WriterLoop, this);
+	return true;
+}
+
+/**
+ * @brief Get a frame to fill in, waiting for the writer to free one up if it
+ * has to.
+ * @return trajectory_frame* The frame, to be handed back with SubmitFrame()
+ */
+struct trajectory_frame * TrajectoryRecorder::AcquireFrame(void) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	frame_freed_.wait(lock, [this] { return !free_.empty(); });
+	struct trajectory_frame * frame = free_.back();
+	free_.pop_back();
+	return frame;
+}
+
+/**
+ * @brief Hand a filled in frame to the writer.
+ * @param frame A frame from AcquireFrame()
+ */
+void TrajectoryRecorder::SubmitFrame(struct trajectory_frame * const frame) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		ready_.push_back(frame);
+	}
+	frame_ready_.notify_one();
+}
+
+/**
+ * @brief Write out every frame submitted, close the file and stop the writer
+ * thread.
+ * @return bool Whether everything recorded was written
+ */
+bool TrajectoryRecorder::Close(void) {
+	if (!file_) {
+		return true;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		closing_ = true;
+	}
+	frame_ready_.notify_one();
+	writer_.join();
+	FlushChunk();
+	WriteIndex();
+	bool written = fclose(file_) == 0 && !failed_;
+	file_ = nullptr;
+	return written;
+}
+
+/**
+ * @brief Body of the writer thread: encode each frame submitted, until the
+ * recorder is closed.
+ */
+void TrajectoryRecorder::WriterLoop(void) {
+	for (;;) {
+		struct trajectory_frame * frame;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			frame_ready_.wait(lock, [this] { return !ready_.empty() || closing_; });
+			if (ready_.empty()) {
+				return;
+			}
+			frame = ready_.front();
+			ready_.pop_front();
+		}
+		Encode(frame);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			free_.push_back(frame);
+		}
+		frame_freed_.notify_one();
+	}
+}
+
+/**
+ * @brief Append a frame to the chunk being built, starting a new chunk first
+ * if it is full, the frame doesn't follow on from the last one, or the
+ * offsets of the block table could overflow.
+ * @param frame The frame; it holds the previous frame's values afterwards
+ */
+void TrajectoryRecorder::Encode(struct trajectory_frame * const frame) {
+	size_t n = frame->x.size();
+	size_t largest = 0;
+	for (const auto& column : columns_) {
+		largest = std::max(largest, column.size());
+	}
+	if (chunk_ticks_ == keyframe_interval_ ||
+	    (chunk_ticks_ > 0 && frame->tick != previous_.tick + 1) ||
+	    largest + n * kMaxValueBytes > std::numeric_limits<uint32_t>::max()) {
+		FlushChunk();
+	}
+	// A keyframe is coded against 0, so the chunk can be read on its own
+	if (chunk_ticks_ == 0) {
+		chunk_first_tick_ = frame->tick;
+		std::fill(previous_.x.begin(), previous_.x.end(), 0);
+		std::fill(previous_.y.begin(), previous_.y.end(), 0);
+		std::fill(previous_.heading.begin(), previous_.heading.end(), 0);
+		std::fill(previous_.speed.begin(), previous_.speed.end(), 0);
+		std::fill(previous_.flags.begin(), previous_.flags.end(), 0);
+	}
+
+	auto put_coordinate = [](int32_t v, int32_t prev,
+	                         std::vector<uint8_t> * const out) {
+		PutVarint(ZigZag(static_cast<int64_t>(v) - prev), out);
+	};
+	auto put_flags = [](uint8_t v, uint8_t prev,
+	                    std::vector<uint8_t> * const out) {
+		PutVarint(v ^ prev, out);
+	};
+	EncodeColumn(frame->x, previous_.x, put_coordinate, &columns_[kColumnX],
+	             &blocks_[kColumnX]);
+	EncodeColumn(frame->y, previous_.y, put_coordinate, &columns_[kColumnY],
+	             &blocks_[kColumnY]);
+	EncodeColumn(frame->heading, previous_.heading, PutDouble,
+	             &columns_[kColumnHeading], &blocks_[kColumnHeading]);
+	EncodeColumn(frame->speed, previous_.speed, PutDouble,
+	             &columns_[kColumnSpeed], &blocks_[kColumnSpeed]);
+	EncodeColumn(frame->flags, previous_.flags, put_flags,
+	             &columns_[kColumnFlags], &blocks_[kColumnFlags]);
+	++chunk_ticks_;
+
+	// The frame goes back to be filled in again, so its values can be traded
+	// for the old ones instead of copied
+	std::swap(*frame, previous_);
+}
+
+/**
+ * @brief Write out the chunk being built, if it holds any ticks, and start an
+ * empty one.
+ */
+void TrajectoryRecorder::FlushChunk(void) {
+	if (chunk_ticks_ == 0) {
+		return;
+	}
+	struct trajectory_index_entry entry;
+	entry.first_tick = chunk_first_tick_;
+	entry.offset = bytes_written_;
+	entry.n_ticks = chunk_ticks_;
+	index_.push_back(entry);
+
+	std::vector<uint8_t> header;
+	StateWriter w(&header);
+	w.Write(kTrajectoryChunkMagic);
+	w.Write(chunk_ticks_);
+	w.Write(chunk_first_tick_);
+	for (const auto& column : columns_) {
+		w.Write(static_cast<uint64_t>(column.size()));
+	}
+	WriteBytes(header.data(), header.size());
+	for (auto& blocks : blocks_) {
+		WriteBytes(reinterpret_cast<const uint8_t*>(blocks.data()),
+		           blocks.size() * sizeof(uint32_t));
+		blocks.clear();
+	}
+	for (auto& column : columns_) {
+		WriteBytes(column.data(), column.size());
+		column.clear();
+	}
+	// Pad the chunk so the next one starts 8-byte aligned in the file
+	static const uint8_t kZeros[8] = {0};
+	WriteBytes(kZeros, (8 - bytes_written_ % 8) % 8);
+	ticks_written_ += chunk_ticks_;
+	chunk_ticks_ = 0;
+}
+
+/**
+ * @brief Write the index of the chunks written and the trailer that locates
+ * it.
+ */
+void TrajectoryRecorder::WriteIndex(void) {
+	struct trajectory_trailer trailer;
+	trailer.index_offset = bytes_written_;
+	trailer.n_chunks = index_.size();
+
+	std::vector<uint8_t> bytes;
+	StateWriter w(&bytes);
+	for (const auto& entry : index_) {
+		w.Write(entry.first_tick);
+		w.Write(entry.offset);
+		w.Write(entry.n_ticks);
+		w.Write(entry.reserved);
+	}
+	w.Write(trailer.index_offset);
+	w.Write(trailer.n_chunks);
+	w.Write(trailer.magic);
+	w.Write(trailer.version);
+	WriteBytes(bytes.data(), bytes.size());
+}
+
+/**
+ * @brief Write bytes to the file, noting if it fails.
+ */
+void TrajectoryRecorder::WriteBytes(const uint8_t * data, size_t size) {
+	if (size == 0 || failed_) {
+		return;
+	}
+	if (fwrite(data, 1, size, file_) != size) {
+		failed_ = true;
+		return;
+	}
+	bytes_written_ += size;
+}
+
+NAMESPACE_END(csci3081);
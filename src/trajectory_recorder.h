@@ -0,0 +1,194 @@
+/**
+ * @file trajectory_recorder.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_TRAJECTORY_RECORDER_H_
+#define SRC_TRAJECTORY_RECORDER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "src/common.h"
+#include "src/trajectory_format.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief Where every recorded entity was at the end of one tick, column by
+ * column, in the order of the trajectory's entity table.
+ */
+struct trajectory_frame {
+	trajectory_frame(void) : tick(0), x(), y(), heading(), speed(), flags() {
+	}
+
+	uint64_t tick; // Arena::ticks() at the end of the tick
+	std::vector<int32_t> x; // x coordinate of each entity
+	std::vector<int32_t> y; // y coordinate of each entity
+	std::vector<double> heading; // heading angle of each entity
+	std::vector<double> speed; // speed of each entity
+	std::vector<uint8_t> flags; // kTrajectory* bits of each entity
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Streams the trajectory of every mobile entity of a game to a file,
+ * tick by tick, while the game is played.
+ *
+ * An arena handed a recorder with \ref Arena::set_trajectory_recorder() fills
+ * in a frame at the end of every tick and hands it back; a thread of the
+ * recorder's own encodes the frames (see trajectory_format.h) and writes them
+ * out a chunk at a time, so the arena only pays for copying the numbers out.
+ * A few frames are kept in flight; if the writer falls that far behind,
+ * \ref AcquireFrame() waits for it rather than use more memory.
+ */
+class TrajectoryRecorder {
+public:
+	/**
+	 * @brief TrajectoryRecorder constructor. Nothing is recorded until
+	 * \ref Open() is called.
+	 */
+	TrajectoryRecorder(void);
+
+	/**
+	 * @brief TrajectoryRecorder destructor. Closes the file if it is open.
+	 */
+	~TrajectoryRecorder(void);
+
+	TrajectoryRecorder(const TrajectoryRecorder& other) = delete;
+	TrajectoryRecorder& operator=(const TrajectoryRecorder& other) = delete;
+
+	/**
+	 * @brief Start recording to a file, and start the writer thread.
+	 * @param path Path of the file, which is replaced if it exists
+	 * @param entities The entities each frame holds, in order (see
+	 * \ref Arena::trajectory_entities())
+	 * @param keyframe_interval Most ticks in a chunk; a reader can start at
+	 * the first tick of any chunk
+	 * @return bool Whether the file could be opened; if not, nothing is
+	 * recorded
+	 */
+	bool Open(const char * path,
+	          const std::vector<struct trajectory_entity>& entities,
+	          unsigned int keyframe_interval = kDefaultKeyframeInterval);
+
+	/**
+	 * @brief Get a frame to fill in, waiting for the writer to free one up if
+	 * it has to. Every column is sized for the entities passed to
+	 * \ref Open(), and holds whatever the frame held before.
+	 * @return trajectory_frame* The frame, to be handed back with
+	 * \ref SubmitFrame()
+	 */
+	struct trajectory_frame * AcquireFrame(void);
+
+	/**
+	 * @brief Hand a filled in frame to the writer. Frames must be submitted
+	 * in the order of their ticks.
+	 * @param frame A frame from \ref AcquireFrame()
+	 */
+	void SubmitFrame(struct trajectory_frame * const frame);
+
+	/**
+	 * @brief Write out every frame submitted, close the file and stop the
+	 * writer thread.
+	 * @return bool Whether everything recorded was written
+	 */
+	bool Close(void);
+
+	/**
+	 * @brief Whether the recorder is open.
+	 */
+	bool is_open(void) const {
+		return file_ != nullptr;
+	}
+
+	/**
+	 * @brief Get the number of ticks written to the file, once it is closed.
+	 */
+	uint64_t ticks_written(void) const {
+		return ticks_written_;
+	}
+
+	/**
+	 * @brief Get the number of bytes written to the file, once it is closed.
+	 */
+	uint64_t bytes_written(void) const {
+		return bytes_written_;
+	}
+
+private:
+	/**
+	 * @brief Body of the writer thread: encode each frame submitted, until the
+	 * recorder is closed.
+	 */
+	void WriterLoop(void);
+
+	/**
+	 * @brief Append a frame to the chunk being built, starting a new chunk
+	 * first if it is full, the frame doesn't follow on from the last one, or
+	 * the offsets of the block table could overflow.
+	 * @param frame The frame; it holds the previous frame's values afterwards
+	 */
+	void Encode(struct trajectory_frame * const frame);
+
+	/**
+	 * @brief Write out the chunk being built, if it holds any ticks, and
+	 * start an empty one.
+	 */
+	void FlushChunk(void);
+
+	/**
+	 * @brief Write the index of the chunks written and the trailer that
+	 * locates it.
+	 */
+	void WriteIndex(void);
+
+	/**
+	 * @brief Write bytes to the file, noting if it fails.
+	 */
+	void WriteBytes(const uint8_t * data, size_t size);
+
+	FILE * file_; // file being recorded to (nullptr if not open)
+	unsigned int keyframe_interval_; // most ticks in a chunk
+	bool failed_; // whether a write to the file has failed
+
+	// Frames in flight between the arena and the writer thread
+	std::vector<struct trajectory_frame> frames_; // every frame there is
+	std::vector<struct trajectory_frame*> free_; // frames the arena can fill in
+	std::deque<struct trajectory_frame*> ready_; // frames waiting to be encoded, in order
+	bool closing_; // whether the writer should stop once ready_ is empty
+	std::mutex mutex_; // guards free_, ready_ and closing_
+	std::condition_variable frame_freed_; // signalled when a frame goes back in free_
+	std::condition_variable frame_ready_; // signalled when a frame goes in ready_ or closing_ is set
+	std::thread writer_; // encodes and writes the frames
+
+	// Owned by the writer thread while it runs
+	struct trajectory_frame previous_; // values each entity is coded against
+	std::vector<uint8_t> columns_[kNumColumns]; // chunk being built, column by column
+	std::vector<uint32_t> blocks_[kNumColumns]; // block table of the chunk being built, column by column
+	std::vector<struct trajectory_index_entry> index_; // chunks written so far
+	uint32_t chunk_ticks_; // ticks in the chunk being built
+	uint64_t chunk_first_tick_; // first tick of the chunk being built
+	uint64_t ticks_written_; // ticks written out so far
+	uint64_t bytes_written_; // bytes written out so far
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRAJECTORY_RECORDER_H_
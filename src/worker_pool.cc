@@ -0,0 +1,121 @@
+/**
+ * @file worker_pool.cc
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/worker_pool.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+/**
+ * @brief WorkerPool constructor, for a pool of size 1.
+ */
+WorkerPool::WorkerPool(void) : threads_(), mutex_(), start_cv_(), done_cv_(),
+	task_(nullptr), generation_(0), pending_(0), stopping_(false) {
+}
+
+/**
+ * @brief WorkerPool destructor. Stops and joins the worker threads.
+ */
+WorkerPool::~WorkerPool(void) {
+	Stop();
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+/**
+ * @brief Change the number of workers.
+ * @param n_workers Number of workers, including the calling thread (at least 1)
+ */
+void WorkerPool::Resize(unsigned int n_workers) {
+	if (n_workers < 1) {
+		n_workers = 1;
+	}
+	if (n_workers == size()) {
+		return;
+	}
+	Stop();
+	stopping_ = false;
+	for (unsigned int i = 1; i < n_workers; ++i) {
+		threads_.push_back(std::thread(&WorkerPool::WorkerLoop, this, i,
+		                               generation_));
+	}
+}
+
+/**
+ * @brief Run a task once on every worker and wait for all of them to finish.
+ * @param task Called with the index of the worker running it, from 0 (the
+ * calling thread) to size() - 1
+ */
+void WorkerPool::Run(const std::function<void(unsigned int)>& task) {
+	if (threads_.empty()) {
+		task(0);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		task_ = &task;
+		pending_ = threads_.size();
+		++generation_;
+	}
+	start_cv_.notify_all();
+
+	task(0);
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_cv_.wait(lock, [this] { return pending_ == 0; });
+	task_ = nullptr;
+}
+
+/**
+ * @brief Body of worker thread index: wait for a task, run it, repeat.
+ * @param index Index of the worker
+ * @param seen Number of tasks posted before the worker was started
+ */
+void WorkerPool::WorkerLoop(unsigned int index, unsigned long seen) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;) {
+		start_cv_.wait(lock, [this, seen] {
+			return stopping_ || generation_ != seen;
+		});
+		if (stopping_) {
+			return;
+		}
+		seen = generation_;
+		const std::function<void(unsigned int)> * task = task_;
+		lock.unlock();
+		(*task)(index);
+		lock.lock();
+		if (--pending_ == 0) {
+			done_cv_.notify_one();
+		}
+	}
+}
+
+/**
+ * @brief Stop and join all the worker threads.
+ */
+void WorkerPool::Stop(void) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	start_cv_.notify_all();
+	for (auto& t : threads_) {
+		t.join();
+	}
+	threads_.clear();
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,97 @@
+/**
+ * @file worker_pool.h
+ *
+ * @copyright 2017 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_WORKER_POOL_H_
+#define SRC_WORKER_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A fixed set of threads that all run the same task and wait for each
+ * other to finish.
+ *
+ * The calling thread takes part as worker 0, so a pool of size 1 has no extra
+ * threads at all and \ref Run() is just a function call.
+ */
+class WorkerPool {
+public:
+	/**
+	 * @brief WorkerPool constructor, for a pool of size 1.
+	 */
+	WorkerPool(void);
+
+	/**
+	 * @brief WorkerPool destructor. Stops and joins the worker threads.
+	 */
+	~WorkerPool(void);
+
+	/**
+	 * @brief Change the number of workers.
+	 * @param n_workers Number of workers, including the calling thread (at
+	 * least 1)
+	 */
+	void Resize(unsigned int n_workers);
+
+	/**
+	 * @brief Get the number of workers, including the calling thread.
+	 */
+	unsigned int size(void) const {
+		return threads_.size() + 1;
+	}
+
+	/**
+	 * @brief Run a task once on every worker and wait for all of them to
+	 * finish.
+	 * @param task Called with the index of the worker running it, from 0 (the
+	 * calling thread) to size() - 1
+	 */
+	void Run(const std::function<void(unsigned int)>& task);
+
+private:
+	/**
+	 * @brief Body of worker thread index: wait for a task, run it, repeat.
+	 * @param index Index of the worker
+	 * @param seen Number of tasks posted before the worker was started
+	 */
+	void WorkerLoop(unsigned int index, unsigned long seen);
+
+	/**
+	 * @brief Stop and join all the worker threads.
+	 */
+	void Stop(void);
+
+	WorkerPool& operator=(const WorkerPool& other) = delete;
+	WorkerPool(const WorkerPool& other) = delete;
+
+	std::vector<std::thread> threads_; // workers 1 and up
+	std::mutex mutex_; // guards everything below
+	std::condition_variable start_cv_; // signalled when a task is posted
+	std::condition_variable done_cv_; // signalled when the last worker finishes
+	const std::function<void(unsigned int)> * task_; // task being run
+	unsigned long generation_; // number of tasks posted so far
+	unsigned int pending_; // worker threads still running the task
+	bool stopping_; // whether the worker threads should exit
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_WORKER_POOL_H_